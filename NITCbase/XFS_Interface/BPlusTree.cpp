@@ -2,14 +2,24 @@
 #include <cstdio>
 #include <queue>
 #include <iostream>
+#include <vector>
+#include <algorithm>
 #include "BPlusTree.h"
 #include "define/constants.h"
 #include "define/errors.h"
 #include "disk_structures.h"
 #include "block_access.h"
+#include "Disk.h"
 
 using namespace std;
 
+/*
+ * Order of the entries of a B+ tree, on their attribute values, with NaN after every other NUMBER (see compareSortKeys)
+ */
+static bool isIndexEntryLess(const Index &entry1, const Index &entry2, int attrType) {
+	return compareSortKeys(entry1.attrVal, entry2.attrVal, attrType, ASC) < 0;
+}
+
 BPlusTree::BPlusTree(int relId, char attrName[ATTR_SIZE]) {
 	// initialise object instance member fields
 	this->relId = relId;
@@ -32,31 +42,6 @@ BPlusTree::BPlusTree(int relId, char attrName[ATTR_SIZE]) {
 
 	// CREATING A NEW B+ TREE
 
-	// getting free block as leaf index/root block
-	int root_block = getFreeBlock(IND_LEAF);
-	if (root_block == FAILURE) {   //Problem in getting free leaf index block
-		this->rootBlock = E_DISKFULL;
-		return;
-	}
-
-	this->rootBlock = root_block;
-
-	// set header for root block
-	HeadInfo headInfo;
-	headInfo.blockType = IND_LEAF;
-	headInfo.pblock = -1;
-	headInfo.lblock = -1;
-	headInfo.rblock = -1;
-	headInfo.numEntries = 0;
-	setHeader(&headInfo, root_block);
-
-	// update AttrCatEntry with root block
-	attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval = root_block;
-	if (setAttrCatEntry(relId, attrName, attrCatEntry) != SUCCESS) {
-		this->rootBlock = FAILURE;
-		return;
-	}
-
 	// get num of attrs, record block number from relCatEntry
 	Attribute relCatEntry[6];
 	if (getRelCatEntry(relId, relCatEntry) != SUCCESS) {
@@ -71,47 +56,227 @@ BPlusTree::BPlusTree(int relId, char attrName[ATTR_SIZE]) {
 	attrOffset = (int) attrCatEntry[ATTRCAT_OFFSET_INDEX].nval;
 	attrType = (int) attrCatEntry[ATTRCAT_ATTR_TYPE_INDEX].nval;
 
-	Attribute record[numAttrs];
-
-	// inserting index entries for each record in bplus tree
+	// collect an index entry for each record of the relation
+	std::vector<Index> entries;
+	entries.reserve((size_t) relCatEntry[RELCAT_NO_RECORDS_INDEX].nval);
+	RecordBatch batch;
 	while (dataBlock != -1) {
-		// get header of record block
-		HeadInfo header;
-		header = getHeader(dataBlock);
+		// get header, slotmap and occupied records of record block
+		if (getRecordBatch(&batch, dataBlock) != SUCCESS)
+			break;
 
-		int num_records = header.numEntries;
-		int num_slots = header.numSlots;
-		unsigned char slotmap[num_slots];
-		getSlotmap(slotmap, dataBlock);
+		for (int iter = 0; iter < batch.numRecords; iter++) {
+			Index entry;
+			memset(&entry, 0, sizeof(entry));
+			entry.attrVal = batch.records[iter * numAttrs + attrOffset];
+			entry.block = dataBlock;
+			entry.slot = batch.slotNums[iter];
+			entries.push_back(entry);
+		}
+		dataBlock = batch.header.rblock; //next data block for the relation
+	}
 
-		int iter;
-		for (iter = 0; iter < num_records; iter++) {
+	// sort them on the attribute value, keeping records with equal values in record order (as repeated inserts do)
+	std::stable_sort(entries.begin(), entries.end(), [attrType](const Index &entry1, const Index &entry2) {
+		return isIndexEntryLess(entry1, entry2, attrType);
+	});
 
-			// get iter th number record from data block
-			getRecord(record, dataBlock, iter);
+	int root_block = bPlusBulkLoad(entries.data(), entries.size());
+	if (root_block < 0) {
+		this->rootBlock = root_block;
+		return;
+	}
 
-			// get attribute value
-			Attribute attrval;
-			if (attrType == NUMBER) {
-				attrval.nval = record[attrOffset].nval;
-			} else if (attrType == STRING) {
-				strcpy(attrval.sval, record[attrOffset].sval);
-			}
+	// update AttrCatEntry with root block
+	attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval = root_block;
+	if (setAttrCatEntry(relId, attrName, attrCatEntry) != SUCCESS) {
+		bPlusDestroy(root_block);
+		this->rootBlock = FAILURE;
+		return;
+	}
+	this->rootBlock = root_block;
+}
+
+/*
+ * Returns the number of the first of numNodes nodes that numItems items are spread evenly over
+ * (the first numItems % numNodes nodes get one item more than the others) holding item 'item'
+ */
+static int getNodeOfItem(int item, int numItems, int numNodes) {
+	int smallSize = numItems / numNodes;
+	int numLarge = numItems % numNodes;
+	if (item < numLarge * (smallSize + 1))
+		return item / (smallSize + 1);
+	return numLarge + (item - numLarge * (smallSize + 1)) / smallSize;
+}
+
+static int getFirstItemOfNode(int node, int numItems, int numNodes) {
+	int smallSize = numItems / numNodes;
+	int numLarge = numItems % numNodes;
+	return node * smallSize + (node < numLarge ? node : numLarge);
+}
+
+/*
+ * Allocates numBlocks index blocks of the given type into the empty vector blocks,
+ * as one contiguous extent if the disk has one
+ * Returns FAILURE, releasing the blocks it got, if the disk is full
+ */
+static int allocateIndexBlocks(int blockType, int numBlocks, std::vector<int> &blocks) {
+	int first = getFreeBlocks(blockType, numBlocks);
+	if (first >= 0) {
+		for (int iter = 0; iter < numBlocks; iter++)
+			blocks.push_back(first + iter);
+		return SUCCESS;
+	}
+	for (int iter = 0; iter < numBlocks; iter++) {
+		int block = getFreeBlock(blockType);
+		if (block == FAILURE) {
+			for (int allocated : blocks)
+				deleteBlock(allocated);
+			blocks.clear();
+			return FAILURE;
+		}
+		blocks.push_back(block);
+	}
+	return SUCCESS;
+}
 
-			recId rec_id;
-			rec_id.block = dataBlock;
-			rec_id.slot = iter;
+/*
+ * Builds a B+ tree bottom up over numEntries index entries sorted in ascending order of attrVal.
+ * The shape of the tree only depends on numEntries: leaves are filled to INDEX_FILL_FACTOR percent of
+ * MAX_KEYS_LEAF, each level of internal nodes to INDEX_FILL_FACTOR percent of MAX_KEYS_INTERNAL, and entries
+ * are spread evenly over the nodes of a level. So all the blocks are allocated first, one extent per level,
+ * and each block is then written once, whole. As in a tree built by inserts, the key separating two children
+ * of an internal node is the largest value in the left child.
+ * Returns the root block, or E_DISKFULL
+ */
+int BPlusTree::bPlusBulkLoad(Index *entries, int numEntries) {
+	int leafCapacity = MAX_KEYS_LEAF * INDEX_FILL_FACTOR / 100;
+	int internalCapacity = MAX_KEYS_INTERNAL * INDEX_FILL_FACTOR / 100;
+
+	// levels[0] are the leaves, the last level has just the root
+	std::vector<std::vector<int>> levels;
+	int numNodes = (numEntries + leafCapacity - 1) / leafCapacity;
+	if (numNodes == 0)
+		numNodes = 1;
+	while (true) {
+		levels.emplace_back();
+		if (allocateIndexBlocks(levels.size() == 1 ? IND_LEAF : IND_INTERNAL, numNodes, levels.back()) != SUCCESS) {
+			levels.pop_back();
+			for (auto &level : levels)
+				for (int block : level)
+					deleteBlock(block);
+			return E_DISKFULL;
+		}
+		if (numNodes == 1)
+			break;
+		numNodes = (numNodes + internalCapacity) / (internalCapacity + 1);
+	}
 
-			int res = bPlusInsert(attrval, rec_id);
+	unsigned char buffer[BLOCK_SIZE];
+	HeadInfo header;
+
+	// largest attribute value of the subtree rooted at each node of the level being written
+	std::vector<Attribute> maxValues;
+
+	std::vector<int> &leaves = levels[0];
+	int numLeaves = leaves.size();
+	for (int leaf = 0; leaf < numLeaves; leaf++) {
+		int first = getFirstItemOfNode(leaf, numEntries, numLeaves);
+		int last = getFirstItemOfNode(leaf + 1, numEntries, numLeaves);
+
+		memset(buffer, 0, BLOCK_SIZE);
+		header.blockType = IND_LEAF;
+		header.pblock = (levels.size() > 1) ? levels[1][getNodeOfItem(leaf, numLeaves, levels[1].size())] : -1;
+		header.lblock = (leaf > 0) ? leaves[leaf - 1] : -1;
+		header.rblock = (leaf + 1 < numLeaves) ? leaves[leaf + 1] : -1;
+		header.numEntries = last - first;
+		header.numAttrs = 0;
+		header.numSlots = 0;
+		memcpy(buffer, &header, HEADER_SIZE);
+		memcpy(buffer + HEADER_SIZE, entries + first, (last - first) * LEAF_ENTRY_SIZE);
+		Disk::writeBlock(buffer, leaves[leaf]);
+
+		if (last > first)
+			maxValues.push_back(entries[last - 1].attrVal);
+	}
 
-			if (res != SUCCESS) {
-				bPlusDestroy(root_block);
-				this->rootBlock = res;
-				return;
+	for (size_t level = 1; level < levels.size(); level++) {
+		std::vector<int> &children = levels[level - 1];
+		std::vector<int> &nodes = levels[level];
+		int numChildren = children.size();
+		int levelNodes = nodes.size();
+		std::vector<Attribute> childMaxValues;
+		childMaxValues.swap(maxValues);
+
+		for (int node = 0; node < levelNodes; node++) {
+			int first = getFirstItemOfNode(node, numChildren, levelNodes);
+			int last = getFirstItemOfNode(node + 1, numChildren, levelNodes);
+
+			memset(buffer, 0, BLOCK_SIZE);
+			header.blockType = IND_INTERNAL;
+			header.pblock = (level + 1 < levels.size()) ? levels[level + 1][getNodeOfItem(node, levelNodes,
+			                                                                               levels[level + 1].size())] : -1;
+			header.lblock = -1;
+			header.rblock = -1;
+			header.numEntries = last - first - 1;
+			header.numAttrs = 0;
+			header.numSlots = 0;
+			memcpy(buffer, &header, HEADER_SIZE);
+
+			// lChild of entry i is rChild of entry i - 1, so children and keys alternate
+			unsigned char *position = buffer + HEADER_SIZE;
+			for (int child = first; child < last; child++) {
+				memcpy(position, &children[child], LCHILD_SIZE);
+				position += LCHILD_SIZE;
+				if (child + 1 < last) {
+					memcpy(position, &childMaxValues[child], ATTR_SIZE);
+					position += ATTR_SIZE;
+				}
 			}
+			Disk::writeBlock(buffer, nodes[node]);
+
+			maxValues.push_back(childMaxValues[last - 1]);
 		}
-		dataBlock = header.rblock; //next data block for the relation
 	}
+
+	return levels.back()[0];
+}
+
+/*
+ * Binary search over the numEntries keys of a buffered index block, which are entrySize bytes apart from keys on.
+ * Returns the index of the first key greater than or equal to attrVal (greater than attrVal if strict),
+ * or numEntries if there is none. Keys are ordered as the entries of the tree are, with NaN last.
+ */
+static int searchKeys(const unsigned char *keys, int entrySize, int numEntries, Attribute attrVal, int attrType,
+                      bool strict) {
+	int low = 0, high = numEntries;
+	while (low < high) {
+		int mid = (low + high) / 2;
+		Attribute key;
+		memcpy(&key, keys + mid * entrySize, ATTR_SIZE);
+		int flag = compareSortKeys(key, attrVal, attrType, ASC);
+		if (flag < 0 || (strict && flag == 0))
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+/*
+ * Returns the child of the buffered internal index block to descend into to reach the first key greater than or
+ * equal to attrVal (greater than attrVal if strict): the lChild of the first entry with such a key,
+ * or the rChild of the last entry if there is none.
+ */
+static int getInternalChild(const unsigned char *block, Attribute attrVal, int attrType, bool strict) {
+	HeadInfo header;
+	memcpy(&header, block, HEADER_SIZE);
+	int entry = searchKeys(block + HEADER_SIZE + LCHILD_SIZE, LCHILD_SIZE + ATTR_SIZE, header.numEntries, attrVal,
+	                       attrType, strict);
+	// the lChild of entry i is the rChild of entry i - 1, so the rChild of the last entry is at index numEntries
+	int32_t child;
+	memcpy(&child, block + HEADER_SIZE + entry * (LCHILD_SIZE + ATTR_SIZE), LCHILD_SIZE);
+	return child;
 }
 
 int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
@@ -125,34 +290,79 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 	}
 
 	//check if B+ Tree exists for attr
-	int blockNum = this->rootBlock;
-	if (blockNum == -1) {
+	if (this->rootBlock == -1) {
+		this->rootBlock = E_NOINDEX;
+		return E_NOINDEX;
+	}
+
+	int attrType = (int) attrCatEntry[ATTRCAT_ATTR_TYPE_INDEX].nval;
+
+	int root_block = this->rootBlock;
+	int retVal = insertEntry(&root_block, attrType, val, recordId);
+
+	// update the rootBlock of attribute catalog entry if the root split, or to -1 if the tree was destroyed
+	if (root_block != this->rootBlock) {
+		attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval = root_block;
+		setAttrCatEntry(relId, attrName, attrCatEntry);
+	}
+	this->rootBlock = (retVal == SUCCESS) ? root_block : retVal;
+	return retVal;
+}
+
+/*
+ * Adds the entries of a batch of records to the B+ tree with insertEntries, numExisting being about the number of
+ * entries the tree already has
+ */
+int BPlusTree::bPlusInsertBatch(Index *entries, int numEntries, int numExisting) {
+
+	// get attribute catalog entry of target attribute
+	Attribute attrCatEntry[6];
+	int flag = getAttrCatEntry(relId, attrName, attrCatEntry);
+	if (flag != SUCCESS) {
+		this->rootBlock = flag;
+		return flag;
+	}
+
+	//check if B+ Tree exists for attr
+	if (this->rootBlock == -1) {
 		this->rootBlock = E_NOINDEX;
 		return E_NOINDEX;
 	}
 
 	int attrType = (int) attrCatEntry[ATTRCAT_ATTR_TYPE_INDEX].nval;
 
+	int root_block = this->rootBlock;
+	int retVal = insertEntries(&root_block, attrType, entries, numEntries, numExisting);
+
+	// update the rootBlock of attribute catalog entry if the tree was rebuilt or its root split, or to -1 if the
+	// tree was destroyed
+	if (root_block != this->rootBlock) {
+		attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval = root_block;
+		setAttrCatEntry(relId, attrName, attrCatEntry);
+	}
+	this->rootBlock = (retVal == SUCCESS) ? root_block : retVal;
+	return retVal;
+}
+
+/*
+ * Inserts val into the B+ tree rooted at *rootBlock, whose keys are of type attrType.
+ * *rootBlock is set to the new root if the root splits, and to -1 if the disk is full,
+ * in which case the whole tree has been destroyed
+ */
+int BPlusTree::insertEntry(int *rootBlock, int attrType, Attribute val, recId recordId) {
+	int blockNum = *rootBlock;
+	int flag;
+
 	int blockType = getBlockType(blockNum);
 	HeadInfo blockHeader;
 	int num_of_entries, current_entryNumber;
 
 	/******Traverse the B+ Tree to reach the appropriate leaf where insertion can be done******/
+	// go to the lChild of the first entry with a key >= val, or the rChild of the last entry
+	unsigned char block[BLOCK_SIZE];
 	while (blockType != IND_LEAF) {
-		blockHeader = getHeader(blockNum);
-		num_of_entries = blockHeader.numEntries;
-		InternalEntry internalEntry;
-		for (current_entryNumber = 0; current_entryNumber < num_of_entries; ++current_entryNumber) {
-			internalEntry = getInternalEntry(blockNum, current_entryNumber);
-			if (compareAttributes(val, internalEntry.attrVal, attrType) <= 0)
-				break;
-		}
-
-		if (current_entryNumber == num_of_entries) {
-			blockNum = internalEntry.rChild;
-		} else {
-			blockNum = internalEntry.lChild;
-		}
+		Disk::readBlock(block, blockNum);
+		blockNum = getInternalChild(block, val, attrType, false);
 		blockType = getBlockType(blockNum);
 	}
 
@@ -163,47 +373,18 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 	num_of_entries = blockHeader.numEntries;
 
 	Index indices[num_of_entries + 1];
-	Index current_leafEntry;
-	int current_leafEntryIndex = 0;
-	flag = 0;
-	/* iterate through all the entries in the block and copy them to the array indices
-	 * Also insert val at appropriate position in the indices array
-	*/
-	for (current_entryNumber = 0; current_entryNumber < num_of_entries; ++current_entryNumber) {
-		current_leafEntry = getLeafEntry(blockNum, current_entryNumber);
-
-		if (flag == 0) {
-			if (compareAttributes(val, current_leafEntry.attrVal, attrType) < 0) {
-				if (attrType == NUMBER) {
-					indices[current_leafEntryIndex].attrVal.nval = val.nval;
-				} else if (attrType == STRING) {
-					strcpy(indices[current_leafEntryIndex].attrVal.sval, val.sval);
-				}
-				indices[current_leafEntryIndex].block = recordId.block;
-				indices[current_leafEntryIndex].slot = recordId.slot;
-				flag = 1;
-				current_leafEntryIndex++;
-			}
-		}
-		if (attrType == NUMBER) {
-			indices[current_leafEntryIndex].attrVal.nval = current_leafEntry.attrVal.nval;
-		} else if (attrType == STRING) {
-			strcpy(indices[current_leafEntryIndex].attrVal.sval, current_leafEntry.attrVal.sval);
-		}
-		indices[current_leafEntryIndex].block = current_leafEntry.block;
-		indices[current_leafEntryIndex].slot = current_leafEntry.slot;
-		current_leafEntryIndex++;
-	}
-
-	if (num_of_entries == current_leafEntryIndex) {
-		if (attrType == NUMBER)
-			indices[current_leafEntryIndex].attrVal.nval = val.nval;
-		if (attrType == STRING)
-			strcpy(indices[current_leafEntryIndex].attrVal.sval, val.sval);
-		indices[current_leafEntryIndex].block = recordId.block;
-		indices[current_leafEntryIndex].slot = recordId.slot;
-		current_leafEntryIndex++;
-	}
+	/* copy all the entries of the block to the array indices with one read,
+	 * and insert val after the entries with keys <= val
+	 */
+	Disk::readBlock(block, blockNum);
+	memcpy(indices, block + HEADER_SIZE, num_of_entries * LEAF_ENTRY_SIZE);
+	int position = searchKeys(block + HEADER_SIZE, LEAF_ENTRY_SIZE, num_of_entries, val, attrType, true);
+	memmove(indices + position + 1, indices + position, (num_of_entries - position) * LEAF_ENTRY_SIZE);
+	memset(&indices[position], 0, LEAF_ENTRY_SIZE);
+	indices[position].attrVal = val;
+	indices[position].block = recordId.block;
+	indices[position].slot = recordId.slot;
+	int current_leafEntryIndex = num_of_entries + 1;
 
 	//leaf block has not reached max limit
 	if (num_of_entries != MAX_KEYS_LEAF) {
@@ -229,13 +410,9 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 			//failed to obtain an empty leaf index because the disk is full
 
 			//destroy the existing B+ tree by passing rootBlock member field to bPlusDestroy().
-			bPlusDestroy(this->rootBlock);
-
-			//update the rootBlock of attribute catalog entry to -1
-			attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval = -1;
-			setAttrCatEntry(relId, attrName, attrCatEntry);
+			bPlusDestroy(*rootBlock);
 
-			this->rootBlock = E_DISKFULL;
+			*rootBlock = -1;
 			return E_DISKFULL;
 		}
 
@@ -304,10 +481,7 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 		leafentry = getLeafEntry(leftBlkNum, MIDDLE_INDEX_LEAF);
 		Attribute newAttrVal;
 
-		if (attrType == NUMBER)
-			newAttrVal.nval = leafentry.attrVal.nval;
-		if (attrType == STRING)
-			strcpy(newAttrVal.sval, leafentry.attrVal.sval);
+		newAttrVal = leafentry.attrVal;
 
 		bool done = false;
 
@@ -332,11 +506,7 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 					if (flag == 0) {
 //						if (compareAttributes(newAttrVal, internalEntry.attrVal, attrType) <= 0) {
 						if (internalEntry.lChild == leftBlkNum) {
-							if (attrType == NUMBER) {
-								internal_entries[current_entryNumber].attrVal.nval = newAttrVal.nval;
-							} else if (attrType == STRING) {
-								strcpy(internal_entries[current_entryNumber].attrVal.sval, newAttrVal.sval);
-							}
+							internal_entries[current_entryNumber].attrVal = newAttrVal;
 							internal_entries[current_entryNumber].lChild = leftBlkNum;
 							internal_entries[current_entryNumber].rChild = newRightBlkNum;
 							flag = 1;
@@ -345,11 +515,7 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 					}
 
 					// copy entries of the parentBlock to the array internal_entries
-					if (attrType == NUMBER) {
-						internal_entries[current_entryNumber].attrVal.nval = internalEntry.attrVal.nval;
-					} else if (attrType == STRING) {
-						strcpy(internal_entries[current_entryNumber].attrVal.sval, internalEntry.attrVal.sval);
-					}
+					internal_entries[current_entryNumber].attrVal = internalEntry.attrVal;
 					if (current_entryNumber - 1 >= 0) {
 						internal_entries[current_entryNumber].lChild = internal_entries[current_entryNumber - 1].rChild;
 					} else {
@@ -361,11 +527,7 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 				// TODO : review
 				if (flag == 0) //when newattrval is greater than all parentblock enries
 				{
-					if (attrType == NUMBER) {
-						internal_entries[current_entryNumber].attrVal.nval = newAttrVal.nval;
-					} else if (attrType == STRING) {
-						strcpy(internal_entries[current_entryNumber].attrVal.sval, newAttrVal.sval);
-					}
+					internal_entries[current_entryNumber].attrVal = newAttrVal;
 					internal_entries[current_entryNumber].lChild = leftBlkNum;
 					internal_entries[current_entryNumber].rChild = newRightBlkNum;
 				}
@@ -391,11 +553,8 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 						// destroy the right subtree, given by newRightBlkNum, build up till now that has not yet been connected to the existing B+ Tree
 						bPlusDestroy(newRightBlkNum);
 						// destroy the existing B+ tree by passing rootBlock member field
-						bPlusDestroy(this->rootBlock);
-						// update the rootBlock of attribute catalog entry to -1
-						attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval = -1;
-						setAttrCatEntry(relId, attrName, attrCatEntry);
-						this->rootBlock = E_DISKFULL;
+						bPlusDestroy(*rootBlock);
+						*rootBlock = -1;
 						return E_DISKFULL;
 					}
 
@@ -479,11 +638,8 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 					// destroy the right subtree, given by newRightBlkNum, build up till now that has not yet been connected to the existing B+ Tree
 					bPlusDestroy(newRightBlkNum);
 					// destroy the existing B+ tree by passing rootBlock member field
-					bPlusDestroy(this->rootBlock);
-					// update the rootBlock of attribute catalog entry to -1
-					attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval = -1;
-					setAttrCatEntry(relId, attrName, attrCatEntry);
-					this->rootBlock = E_DISKFULL;
+					bPlusDestroy(*rootBlock);
+					*rootBlock = -1;
 					return E_DISKFULL;
 				}
 
@@ -492,10 +648,7 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 				 * as the first entry to new_root_block
 				*/
 				InternalEntry rootEntry;
-				if (attrType == NUMBER)
-					rootEntry.attrVal.nval = newAttrVal.nval;
-				else if (attrType == STRING)
-					strcpy(rootEntry.attrVal.sval, newAttrVal.sval);
+				rootEntry.attrVal = newAttrVal;
 				rootEntry.lChild = leftBlkNum;
 				rootEntry.rChild = newRightBlkNum;
 				setInternalEntry(rootEntry, new_root_block, 0);
@@ -513,10 +666,7 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 				setHeader(&header1, leftBlkNum);
 				setHeader(&header2, newRightBlkNum);
 
-				attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval = new_root_block;
-				setAttrCatEntry(relId, attrName, attrCatEntry);
-
-				this->rootBlock = new_root_block;
+				*rootBlock = new_root_block;
 				done = true;
 			}
 		}
@@ -524,6 +674,377 @@ int BPlusTree::bPlusInsert(Attribute val, recId recordId) {
 	return SUCCESS;
 }
 
+/*
+ * Adds numEntries entries, in any order, to the B+ tree rooted at *rootBlock, which has about numExisting entries.
+ * The entries are sorted first. If there are at least 1/INDEX_REBUILD_RATIO as many of them as there are in the
+ * tree, the entries of the tree are read off its leaves and merged with them, and a tree bulk loaded from the
+ * result replaces it. Otherwise, or if the disk has no room for the new tree next to the old one, they are
+ * inserted one by one in order, so that consecutive inserts go down the same path.
+ * *rootBlock is updated as by insertEntry
+ */
+int BPlusTree::insertEntries(int *rootBlock, int attrType, Index *entries, int numEntries, int numExisting) {
+	// keep entries with equal values in record order, after the entries already in the tree
+	std::stable_sort(entries, entries + numEntries, [attrType](const Index &entry1, const Index &entry2) {
+		return isIndexEntryLess(entry1, entry2, attrType);
+	});
+
+	if (numEntries > 0 && (long long) numEntries * INDEX_REBUILD_RATIO >= numExisting) {
+		std::vector<Index> treeEntries;
+		treeEntries.reserve(numExisting);
+
+		// go down the first children to the first leaf, and follow the leaves from there
+		unsigned char block[BLOCK_SIZE];
+		int blockNum = *rootBlock;
+		while (getBlockType(blockNum) == IND_INTERNAL) {
+			Disk::readBlock(block, blockNum);
+			memcpy(&blockNum, block + HEADER_SIZE, LCHILD_SIZE);
+		}
+		while (blockNum != -1) {
+			Disk::readBlock(block, blockNum);
+			HeadInfo header;
+			memcpy(&header, block, HEADER_SIZE);
+			Index *leafEntries = (Index *) (block + HEADER_SIZE);
+			treeEntries.insert(treeEntries.end(), leafEntries, leafEntries + header.numEntries);
+			blockNum = header.rblock;
+		}
+
+		std::vector<Index> merged(treeEntries.size() + numEntries);
+		std::merge(treeEntries.begin(), treeEntries.end(), entries, entries + numEntries, merged.begin(),
+		           [attrType](const Index &entry1, const Index &entry2) {
+			           return isIndexEntryLess(entry1, entry2, attrType);
+		           });
+
+		int newRootBlock = bPlusBulkLoad(merged.data(), merged.size());
+		if (newRootBlock >= 0) {
+			bPlusDestroy(*rootBlock);
+			*rootBlock = newRootBlock;
+			return SUCCESS;
+		}
+	}
+
+	for (int iter = 0; iter < numEntries; iter++) {
+		int ret = insertEntry(rootBlock, attrType, entries[iter].attrVal, {entries[iter].block, entries[iter].slot});
+		if (ret != SUCCESS)
+			return ret;
+	}
+	return SUCCESS;
+}
+
+int BPlusTree::bPlusDelete(Attribute val, recId recordId) {
+
+	// get attribute catalog entry of target attribute
+	Attribute attrCatEntry[6];
+	int flag = getAttrCatEntry(relId, attrName, attrCatEntry);
+	if (flag != SUCCESS)
+		return flag;
+
+	//check if B+ Tree exists for attr
+	if (this->rootBlock == -1)
+		return E_NOINDEX;
+
+	int attrType = (int) attrCatEntry[ATTRCAT_ATTR_TYPE_INDEX].nval;
+
+	int root_block = this->rootBlock;
+	int retVal = deleteEntry(&root_block, attrType, val, recordId);
+
+	// update the rootBlock of attribute catalog entry if the tree lost a level
+	if (root_block != this->rootBlock) {
+		attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval = root_block;
+		setAttrCatEntry(relId, attrName, attrCatEntry);
+		this->rootBlock = root_block;
+	}
+	return retVal;
+}
+
+/*
+ * A B+ tree node read whole from its block, so that entries can be moved between siblings in memory.
+ * An internal node has numEntries keys and numEntries + 1 children; one more of each fits for a borrow.
+ */
+typedef struct LeafNode {
+	HeadInfo header;
+	Index entries[MAX_KEYS_LEAF + 1];
+} LeafNode;
+
+typedef struct InternalNode {
+	HeadInfo header;
+	int32_t children[MAX_KEYS_INTERNAL + 2];
+	Attribute keys[MAX_KEYS_INTERNAL + 1];
+} InternalNode;
+
+static void readLeafNode(LeafNode &node, int blockNum) {
+	unsigned char buffer[BLOCK_SIZE];
+	Disk::readBlock(buffer, blockNum);
+	memcpy(&node.header, buffer, HEADER_SIZE);
+	memcpy(node.entries, buffer + HEADER_SIZE, node.header.numEntries * LEAF_ENTRY_SIZE);
+}
+
+static void writeLeafNode(LeafNode &node, int blockNum) {
+	unsigned char buffer[BLOCK_SIZE];
+	memset(buffer, 0, BLOCK_SIZE);
+	memcpy(buffer, &node.header, HEADER_SIZE);
+	memcpy(buffer + HEADER_SIZE, node.entries, node.header.numEntries * LEAF_ENTRY_SIZE);
+	Disk::writeBlock(buffer, blockNum);
+}
+
+static void readInternalNode(InternalNode &node, int blockNum) {
+	unsigned char buffer[BLOCK_SIZE];
+	Disk::readBlock(buffer, blockNum);
+	memcpy(&node.header, buffer, HEADER_SIZE);
+	// lChild of entry i is rChild of entry i - 1, so children and keys alternate
+	unsigned char *position = buffer + HEADER_SIZE;
+	for (int iter = 0; iter <= node.header.numEntries; iter++) {
+		memcpy(&node.children[iter], position, LCHILD_SIZE);
+		position += LCHILD_SIZE;
+		if (iter < node.header.numEntries) {
+			memcpy(&node.keys[iter], position, ATTR_SIZE);
+			position += ATTR_SIZE;
+		}
+	}
+}
+
+static void writeInternalNode(InternalNode &node, int blockNum) {
+	unsigned char buffer[BLOCK_SIZE];
+	memset(buffer, 0, BLOCK_SIZE);
+	memcpy(buffer, &node.header, HEADER_SIZE);
+	unsigned char *position = buffer + HEADER_SIZE;
+	for (int iter = 0; iter <= node.header.numEntries; iter++) {
+		memcpy(position, &node.children[iter], LCHILD_SIZE);
+		position += LCHILD_SIZE;
+		if (iter < node.header.numEntries) {
+			memcpy(position, &node.keys[iter], ATTR_SIZE);
+			position += ATTR_SIZE;
+		}
+	}
+	Disk::writeBlock(buffer, blockNum);
+}
+
+static void setParentBlock(int blockNum, int parentBlock) {
+	HeadInfo header = getHeader(blockNum);
+	header.pblock = parentBlock;
+	setHeader(&header, blockNum);
+}
+
+/*
+ * Removes child 'child' and the key to its left from the internal node, which is then written back
+ */
+static void removeChild(InternalNode &node, int child, int blockNum) {
+	int numEntries = node.header.numEntries;
+	memmove(node.keys + child - 1, node.keys + child, (numEntries - child) * ATTR_SIZE);
+	memmove(node.children + child, node.children + child + 1, (numEntries - child) * LCHILD_SIZE);
+	node.header.numEntries--;
+	writeInternalNode(node, blockNum);
+}
+
+/*
+ * Deletes the entry of val and recordId from the B+ tree rooted at *rootBlock, whose keys are of type attrType.
+ * A leaf or internal node left with fewer than MIN_KEYS_LEAF / MIN_KEYS_INTERNAL keys borrows one from a sibling
+ * that has more, or else is merged with it, which removes a key from the parent and may make it underflow in turn.
+ * The key separating two children stays an upper bound of the left one and a lower bound of the right one.
+ * *rootBlock is set to the only child of the root when the root is left without keys; an emptied tree keeps
+ * its root leaf.
+ * Returns E_NOTFOUND if the tree has no such entry
+ */
+int BPlusTree::deleteEntry(int *rootBlock, int attrType, Attribute val, recId recordId) {
+	// descend to the leaf holding the first entry >= val, as the entries equal to val may span leaves
+	int blockNum = *rootBlock;
+	unsigned char buffer[BLOCK_SIZE];
+	while (getBlockType(blockNum) == IND_INTERNAL) {
+		Disk::readBlock(buffer, blockNum);
+		blockNum = getInternalChild(buffer, val, attrType, false);
+	}
+
+	// find the entry of recordId among the entries equal to val, following the leaf chain
+	LeafNode leaf;
+	int position = -1;
+	while (blockNum != -1) {
+		readLeafNode(leaf, blockNum);
+		int iter = searchKeys((unsigned char *) leaf.entries, LEAF_ENTRY_SIZE, leaf.header.numEntries, val, attrType,
+		                      false);
+		for (; iter < leaf.header.numEntries; iter++) {
+			if (compareSortKeys(leaf.entries[iter].attrVal, val, attrType, ASC) != 0)
+				return E_NOTFOUND;
+			if (leaf.entries[iter].block == recordId.block && leaf.entries[iter].slot == recordId.slot) {
+				position = iter;
+				break;
+			}
+		}
+		if (position != -1)
+			break;
+		blockNum = leaf.header.rblock;
+	}
+	if (position == -1)
+		return E_NOTFOUND;
+
+	memmove(leaf.entries + position, leaf.entries + position + 1,
+	        (leaf.header.numEntries - position - 1) * LEAF_ENTRY_SIZE);
+	leaf.header.numEntries--;
+	writeLeafNode(leaf, blockNum);
+	if (leaf.header.pblock == -1 || leaf.header.numEntries >= MIN_KEYS_LEAF)
+		return SUCCESS;
+
+	/******Rebalance the underflowing leaf with a sibling under the same parent******/
+	int parentBlock = leaf.header.pblock;
+	InternalNode parent;
+	readInternalNode(parent, parentBlock);
+	int child = 0;
+	while (parent.children[child] != blockNum)
+		child++;
+
+	LeafNode sibling;
+	if (child > 0) {
+		int leftBlock = parent.children[child - 1];
+		readLeafNode(sibling, leftBlock);
+		if (sibling.header.numEntries > MIN_KEYS_LEAF) {
+			// move the last entry of the left sibling to the front of the leaf
+			memmove(leaf.entries + 1, leaf.entries, leaf.header.numEntries * LEAF_ENTRY_SIZE);
+			leaf.entries[0] = sibling.entries[--sibling.header.numEntries];
+			leaf.header.numEntries++;
+			parent.keys[child - 1] = sibling.entries[sibling.header.numEntries - 1].attrVal;
+			writeLeafNode(sibling, leftBlock);
+			writeLeafNode(leaf, blockNum);
+			writeInternalNode(parent, parentBlock);
+			return SUCCESS;
+		}
+	}
+	if (child < parent.header.numEntries) {
+		int rightBlock = parent.children[child + 1];
+		readLeafNode(sibling, rightBlock);
+		if (sibling.header.numEntries > MIN_KEYS_LEAF) {
+			// move the first entry of the right sibling to the end of the leaf
+			leaf.entries[leaf.header.numEntries++] = sibling.entries[0];
+			sibling.header.numEntries--;
+			memmove(sibling.entries, sibling.entries + 1, sibling.header.numEntries * LEAF_ENTRY_SIZE);
+			parent.keys[child] = leaf.entries[leaf.header.numEntries - 1].attrVal;
+			writeLeafNode(sibling, rightBlock);
+			writeLeafNode(leaf, blockNum);
+			writeInternalNode(parent, parentBlock);
+			return SUCCESS;
+		}
+	}
+
+	// neither sibling can spare an entry: merge the right one of the pair into the left one
+	int leftBlock, rightBlock;
+	LeafNode left, right;
+	if (child > 0) {
+		leftBlock = parent.children[child - 1];
+		rightBlock = blockNum;
+		readLeafNode(left, leftBlock);
+		right = leaf;
+	} else {
+		leftBlock = blockNum;
+		rightBlock = parent.children[child + 1];
+		left = leaf;
+		readLeafNode(right, rightBlock);
+		child++;
+	}
+	memcpy(left.entries + left.header.numEntries, right.entries, right.header.numEntries * LEAF_ENTRY_SIZE);
+	left.header.numEntries += right.header.numEntries;
+	left.header.rblock = right.header.rblock;
+	writeLeafNode(left, leftBlock);
+	if (right.header.rblock != -1) {
+		HeadInfo nextHeader = getHeader(right.header.rblock);
+		nextHeader.lblock = leftBlock;
+		setHeader(&nextHeader, right.header.rblock);
+	}
+	deleteBlock(rightBlock);
+
+	/******Remove the merged child from its parent, and rebalance the internal nodes bottom up******/
+	blockNum = parentBlock;
+	InternalNode node = parent;
+	removeChild(node, child, blockNum);
+	while (true) {
+		if (node.header.pblock == -1) {
+			// the root is left with a single child, which becomes the root
+			if (node.header.numEntries == 0) {
+				*rootBlock = node.children[0];
+				setParentBlock(node.children[0], -1);
+				deleteBlock(blockNum);
+			}
+			return SUCCESS;
+		}
+		if (node.header.numEntries >= MIN_KEYS_INTERNAL)
+			return SUCCESS;
+
+		parentBlock = node.header.pblock;
+		readInternalNode(parent, parentBlock);
+		child = 0;
+		while (parent.children[child] != blockNum)
+			child++;
+
+		InternalNode siblingNode;
+		if (child > 0) {
+			int leftNodeBlock = parent.children[child - 1];
+			readInternalNode(siblingNode, leftNodeBlock);
+			if (siblingNode.header.numEntries > MIN_KEYS_INTERNAL) {
+				// rotate the last child of the left sibling through the parent key into the front of the node
+				int numEntries = node.header.numEntries;
+				memmove(node.keys + 1, node.keys, numEntries * ATTR_SIZE);
+				memmove(node.children + 1, node.children, (numEntries + 1) * LCHILD_SIZE);
+				node.keys[0] = parent.keys[child - 1];
+				node.children[0] = siblingNode.children[siblingNode.header.numEntries];
+				node.header.numEntries++;
+				parent.keys[child - 1] = siblingNode.keys[siblingNode.header.numEntries - 1];
+				siblingNode.header.numEntries--;
+				writeInternalNode(siblingNode, leftNodeBlock);
+				writeInternalNode(node, blockNum);
+				writeInternalNode(parent, parentBlock);
+				setParentBlock(node.children[0], blockNum);
+				return SUCCESS;
+			}
+		}
+		if (child < parent.header.numEntries) {
+			int rightNodeBlock = parent.children[child + 1];
+			readInternalNode(siblingNode, rightNodeBlock);
+			if (siblingNode.header.numEntries > MIN_KEYS_INTERNAL) {
+				// rotate the first child of the right sibling through the parent key onto the end of the node
+				int numEntries = node.header.numEntries;
+				node.keys[numEntries] = parent.keys[child];
+				node.children[numEntries + 1] = siblingNode.children[0];
+				node.header.numEntries++;
+				parent.keys[child] = siblingNode.keys[0];
+				int siblingEntries = --siblingNode.header.numEntries;
+				memmove(siblingNode.keys, siblingNode.keys + 1, siblingEntries * ATTR_SIZE);
+				memmove(siblingNode.children, siblingNode.children + 1, (siblingEntries + 1) * LCHILD_SIZE);
+				writeInternalNode(siblingNode, rightNodeBlock);
+				writeInternalNode(node, blockNum);
+				writeInternalNode(parent, parentBlock);
+				setParentBlock(node.children[numEntries + 1], blockNum);
+				return SUCCESS;
+			}
+		}
+
+		// merge the right node of the pair, and the parent key between the two, into the left node
+		int leftNodeBlock, rightNodeBlock;
+		InternalNode leftNode, rightNode;
+		if (child > 0) {
+			leftNodeBlock = parent.children[child - 1];
+			rightNodeBlock = blockNum;
+			readInternalNode(leftNode, leftNodeBlock);
+			rightNode = node;
+		} else {
+			leftNodeBlock = blockNum;
+			rightNodeBlock = parent.children[child + 1];
+			leftNode = node;
+			readInternalNode(rightNode, rightNodeBlock);
+			child++;
+		}
+		int numEntries = leftNode.header.numEntries;
+		leftNode.keys[numEntries] = parent.keys[child - 1];
+		memcpy(leftNode.keys + numEntries + 1, rightNode.keys, rightNode.header.numEntries * ATTR_SIZE);
+		memcpy(leftNode.children + numEntries + 1, rightNode.children,
+		       (rightNode.header.numEntries + 1) * LCHILD_SIZE);
+		leftNode.header.numEntries += rightNode.header.numEntries + 1;
+		writeInternalNode(leftNode, leftNodeBlock);
+		for (int iter = 0; iter <= rightNode.header.numEntries; iter++)
+			setParentBlock(rightNode.children[iter], leftNodeBlock);
+		deleteBlock(rightNodeBlock);
+
+		blockNum = parentBlock;
+		node = parent;
+		removeChild(node, child, blockNum);
+	}
+}
+
 recId BPlusTree::BPlusSearch(Attribute attrVal, int op, recId *prev_indexId) {
 	// Used to store search index for attrName
 	indexId searchIndex;
@@ -580,73 +1101,26 @@ recId BPlusTree::BPlusSearch(Attribute attrVal, int op, recId *prev_indexId) {
 	}
 
 	/* Incase of Search for first time, traverse the B+ tree and reach appropriate leaf entry */
-	// Used to store the header of the internal block
-	HeadInfo intHead;
-	// Used to store an internal entry of the internal block
-	InternalEntry internalEntry;
-	/* cond =>
-	 * if 1 move to left child
-	 * else move to right to the next internal entry
-	 */
-	int cond;
+	unsigned char buffer[BLOCK_SIZE];
+	bool firstSearch = (searchIndex.block == -1 && searchIndex.index == -1);
 	while (getBlockType(block) == IND_INTERNAL) {
-		intHead = getHeader(block);
-		int numOfEntries = intHead.numEntries;
-		int currEntryNum;
-		cond = 0;
-		// Iterate over all
-		for (currEntryNum = 0; currEntryNum < numOfEntries; currEntryNum++) {
-			internalEntry = getInternalEntry(block, currEntryNum);
-			int flag = compareAttributes(internalEntry.attrVal, attrVal, attrType);
-			switch (op) {
-				case EQ:
-					if (flag >= 0) {
-						// move to the left child of the first entry that is greater than or equal to attrVal.
-						cond = 1;
-					}
-					break;
-				case LE:
-					// Since indexing is in ascending order, for lesser values always move left
-					cond = 1;
-					break;
-				case LT:
-					// Since indexing is in ascending order, for lesser values always move left
-					cond = 1;
-					break;
-				case GE:
-					if (flag >= 0) {
-						// move to the left child of the first entry that is greater than or equal to attrVal.
-						cond = 1;
-					}
-					break;
-				case GT:
-					if (flag > 0) {
-                        // BUG : HERE (It was >=)
-						// move to the left child of the first entry that is greater than or equal to attrVal.
-						cond = 1;
-					}
-					break;
-				case NE:
-					// Need to search the entire linked list of index
-					// So go to the leftmost entry (move left always)
-					cond = 1;
-					break;
-			}
-
-			if (cond == 1) {
-				// Condition Met in this Internal Block
-				// Now, Search in the Left Child
-				block = internalEntry.lChild;
+		Disk::readBlock(buffer, block);
+		switch (op) {
+			case EQ:
+			case GE:
+				// move to the left child of the first entry that is greater than or equal to attrVal.
+				block = getInternalChild(buffer, attrVal, attrType, false);
+				break;
+			case GT:
+				// move to the left child of the first entry that is greater than attrVal.
+				block = getInternalChild(buffer, attrVal, attrType, true);
+				break;
+			default:
+				/* LE, LT: Since indexing is in ascending order, for lesser values always move left
+				 * NE: Need to search the entire linked list of index, so go to the leftmost entry
+				 */
+				memcpy(&block, buffer + HEADER_SIZE, LCHILD_SIZE);
 				break;
-			} else {
-				// Continue iterating this Internal index block
-				continue;
-			}
-		}
-		if (cond == 0) {
-			// traversed all the entries of internalBlk without satisfying op condition
-			// proceed to search the right child
-			block = internalEntry.rChild;
 		}
 	}
 	/* Traversing of B+ tree has been done and Appropriate Leaf Block has been reached */
@@ -660,12 +1134,19 @@ recId BPlusTree::BPlusSearch(Attribute attrVal, int op, recId *prev_indexId) {
 	 * cond = 1: found a record satisfying the search condition
 	 * cond = -1 : stop searching
 	 */
-	cond = 0;
+	int cond = 0;
 	/* Traverse through index entries in the leaf index block starting from the index entry - index */
 	while (block != -1) {
-		leafHead = getHeader(block);
+		Disk::readBlock(buffer, block);
+		memcpy(&leafHead, buffer, HEADER_SIZE);
+
+		// on the first search, skip the entries less than (or equal to, for GT) attrVal with a binary search
+		if (firstSearch && (op == EQ || op == GE || op == GT))
+			index = searchKeys(buffer + HEADER_SIZE, LEAF_ENTRY_SIZE, leafHead.numEntries, attrVal, attrType, op == GT);
+		firstSearch = false;
+
 		while (index < leafHead.numEntries) {
-			leafEntry = getLeafEntry(block, index);
+			memcpy(&leafEntry, buffer + HEADER_SIZE + index * LEAF_ENTRY_SIZE, LEAF_ENTRY_SIZE);
 			int flag = compareAttributes(leafEntry.attrVal, attrVal, attrType);
 			switch (op) {
 				case EQ:
@@ -745,6 +1226,74 @@ recId BPlusTree::BPlusSearch(Attribute attrVal, int op, recId *prev_indexId) {
 	return {-1, -1};
 }
 
+BPlusRangeScan::BPlusRangeScan(int rootBlock, int attrType) {
+	this->rootBlock = rootBlock;
+	this->attrType = attrType;
+	this->hasLower = false;
+	this->hasUpper = false;
+	// -2 : the scan has not yet seeked to its first leaf, -1 : the scan is over
+	this->nextLeaf = (rootBlock == -1) ? -1 : -2;
+}
+
+void BPlusRangeScan::setLowerBound(Attribute value, bool inclusive) {
+	this->hasLower = true;
+	this->lower = value;
+	this->lowerInclusive = inclusive;
+}
+
+void BPlusRangeScan::setUpperBound(Attribute value, bool inclusive) {
+	this->hasUpper = true;
+	this->upper = value;
+	this->upperInclusive = inclusive;
+}
+
+/*
+ * Copies the entries in range from the next leaf holding any into entries, in ascending order of attribute value
+ * Returns their number, 0 once the scan is over
+ */
+int BPlusRangeScan::getNextBatch(Index entries[MAX_KEYS_LEAF]) {
+	unsigned char buffer[BLOCK_SIZE];
+	bool firstLeaf = false;
+
+	if (nextLeaf == -2) {
+		// seek to the leaf holding the first entry >= (or >) the lower bound, or to the leftmost leaf
+		int block = rootBlock;
+		while (getBlockType(block) == IND_INTERNAL) {
+			Disk::readBlock(buffer, block);
+			if (hasLower)
+				block = getInternalChild(buffer, lower, attrType, !lowerInclusive);
+			else
+				memcpy(&block, buffer + HEADER_SIZE, LCHILD_SIZE);
+		}
+		nextLeaf = block;
+		firstLeaf = true;
+	}
+
+	while (nextLeaf != -1) {
+		Disk::readBlock(buffer, nextLeaf);
+		HeadInfo header;
+		memcpy(&header, buffer, HEADER_SIZE);
+		const unsigned char *keys = buffer + HEADER_SIZE;
+
+		int first = 0;
+		if (firstLeaf && hasLower)
+			first = searchKeys(keys, LEAF_ENTRY_SIZE, header.numEntries, lower, attrType, !lowerInclusive);
+		firstLeaf = false;
+
+		int last = header.numEntries;
+		if (hasUpper)
+			last = searchKeys(keys, LEAF_ENTRY_SIZE, header.numEntries, upper, attrType, upperInclusive);
+		// the scan is over at the first entry past the upper bound, or at the end of the leaf chain
+		nextLeaf = (last < header.numEntries) ? -1 : header.rblock;
+
+		if (last > first) {
+			memcpy(entries, keys + first * LEAF_ENTRY_SIZE, (last - first) * LEAF_ENTRY_SIZE);
+			return last - first;
+		}
+	}
+	return 0;
+}
+
 int BPlusTree::getRootBlock() {
 	return this->rootBlock;
 }
@@ -15,8 +15,35 @@ public:
 	BPlusTree(int relid, char attrName[ATTR_SIZE]);
 	int getRootBlock();
 	int bPlusInsert(union Attribute attrVal, recId recordId);
+	int bPlusInsertBatch(Index *entries, int numEntries, int numExisting);
+	int bPlusDelete(union Attribute attrVal, recId recordId);
 	recId BPlusSearch(union Attribute attrVal, int op, recId *prev_indexId);
+	static int bPlusBulkLoad(Index *entries, int numEntries);
+	static int insertEntry(int *rootBlock, int attrType, union Attribute attrVal, recId recordId);
+	static int insertEntries(int *rootBlock, int attrType, Index *entries, int numEntries, int numExisting);
+	static int deleteEntry(int *rootBlock, int attrType, union Attribute attrVal, recId recordId);
 	static int bPlusDestroy(int blockNum);
 };
 
+/*
+ * Scan of the entries of a B+ tree with attribute values between a lower and an upper bound, either of which may
+ * be left open. The first call to getNextBatch seeks down the tree to the lower bound, and each call then returns
+ * the entries in range from the next leaf, following the rblock links, until the first entry past the upper bound.
+ */
+class BPlusRangeScan {
+private:
+	int rootBlock;
+	int attrType;
+	bool hasLower, lowerInclusive;
+	bool hasUpper, upperInclusive;
+	Attribute lower, upper;
+	int nextLeaf;
+
+public:
+	BPlusRangeScan(int rootBlock, int attrType);
+	void setLowerBound(union Attribute value, bool inclusive);
+	void setUpperBound(union Attribute value, bool inclusive);
+	int getNextBatch(Index entries[MAX_KEYS_LEAF]);
+};
+
 #endif //NITCBASE_BPLUSTREE_H
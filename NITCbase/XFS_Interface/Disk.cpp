@@ -5,6 +5,8 @@
 #include "Disk.h"
 #include "disk_structures.h"
 #include "block_access.h"
+#include "block_allocation.h"
+#include "composite_index.h"
 
 int Disk::createDisk() {
 	FILE *disk = fopen(&DISK_PATH[0], "wb+");
@@ -18,6 +20,8 @@ int Disk::createDisk() {
 	}
 
 	fclose(disk);
+	invalidateBlockAllocationMap();
+	invalidateIndexCatalog();
 	return SUCCESS;
 }
 
@@ -31,6 +35,7 @@ int Disk::readBlock(unsigned char *block, int blockNum) {
 	fseek(disk, offset, SEEK_SET);
 	fread(block, BLOCK_SIZE, 1, disk);
 	fclose(disk);
+	return SUCCESS;
 }
 
 int Disk::writeBlock(unsigned char *block, int blockNum) {
@@ -39,6 +44,7 @@ int Disk::writeBlock(unsigned char *block, int blockNum) {
 	fseek(disk, offset, SEEK_SET);
 	fwrite(block, BLOCK_SIZE, 1, disk);
 	fclose(disk);
+	return SUCCESS;
 }
 
 /*
@@ -72,6 +78,8 @@ void Disk::formatDisk() {
 		fputc(0, disk);
 	}
 	fclose(disk);
+	invalidateBlockAllocationMap();
+	invalidateIndexCatalog();
 
     Disk::add_disk_metainfo();
 }
@@ -6,9 +6,11 @@
 #include "OpenRelTable.h"
 
 OpenRelTableMetaInfo OpenRelTable::tableMetaInfo[MAX_OPEN];;
+FreeSpaceMap OpenRelTable::freeSpaceMap[MAX_OPEN];
 
 void OpenRelTable::initializeOpenRelationTable() {
 	for (int i = 0; i < MAX_OPEN; i++) {
+		freeSpaceMap[i].valid = false;
 		if (i == RELCAT_RELID) {
 			tableMetaInfo[i].free = OCCUPIED;
 			strcpy(tableMetaInfo[i].relName, "RELATIONCAT");
@@ -73,6 +75,7 @@ int OpenRelTable::openRelation(char relationName[ATTR_SIZE]) {
 		if (tableMetaInfo[i].free == FREE) {
 			tableMetaInfo[i].free = OCCUPIED;
 			strcpy(tableMetaInfo[i].relName, relationName);
+			freeSpaceMap[i].valid = false;
 			return i;
 		}
 	}
@@ -95,6 +98,7 @@ int OpenRelTable::closeRelation(int relationId) {
 	}
 	tableMetaInfo[relationId].free = FREE;
 	strcpy(tableMetaInfo[relationId].relName, "NULL");
+	freeSpaceMap[relationId].valid = false;
 	return SUCCESS;
 }
 
@@ -126,4 +130,58 @@ int OpenRelTable::checkIfOpenRelTableHasFreeEntry() {
 		}
 	}
 	return FAILURE;
-}
\ No newline at end of file
+}
+
+/*
+ * Walks the blocks of the relation once, marking the ones with fewer records than slots
+ */
+void OpenRelTable::buildFreeSpaceMap(int relationId) {
+	FreeSpaceMap &map = freeSpaceMap[relationId];
+	memset(map.blocks, 0, sizeof(map.blocks));
+
+	Attribute relCatEntry[RELCAT_NO_ATTRS];
+	getRelCatEntry(relationId, relCatEntry);
+	int blockNum = (int) relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval;
+	while (blockNum != -1) {
+		HeadInfo header = getHeader(blockNum);
+		if (header.numEntries < header.numSlots)
+			map.blocks[blockNum / 64] |= (uint64_t) 1 << (blockNum % 64);
+		blockNum = header.rblock;
+	}
+	map.valid = true;
+}
+
+/*
+ * Returns a record block of the open relation with a free slot, or -1 if all of its blocks are full
+ */
+int OpenRelTable::getFreeSpaceBlock(int relationId) {
+	if (relationId < 0 || relationId >= MAX_OPEN || tableMetaInfo[relationId].free == FREE) {
+		return E_RELNOTOPEN;
+	}
+	if (!freeSpaceMap[relationId].valid) {
+		buildFreeSpaceMap(relationId);
+	}
+	const uint64_t *blocks = freeSpaceMap[relationId].blocks;
+	for (int word = 0; word < DISK_BLOCKS / 64; word++) {
+		if (blocks[word] != 0) {
+			return word * 64 + __builtin_ctzll(blocks[word]);
+		}
+	}
+	return -1;
+}
+
+/*
+ * Records whether a record block of the open relation has a free slot, after a record is inserted into or
+ * deleted from it, or the block is added to or released from the relation
+ */
+void OpenRelTable::setFreeSpace(int relationId, int blockNum, bool hasFreeSlot) {
+	if (relationId < 0 || relationId >= MAX_OPEN || blockNum < 0 || blockNum >= DISK_BLOCKS ||
+	    !freeSpaceMap[relationId].valid) {
+		return;
+	}
+	uint64_t bit = (uint64_t) 1 << (blockNum % 64);
+	if (hasFreeSlot)
+		freeSpaceMap[relationId].blocks[blockNum / 64] |= bit;
+	else
+		freeSpaceMap[relationId].blocks[blockNum / 64] &= ~bit;
+}
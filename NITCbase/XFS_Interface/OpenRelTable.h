@@ -9,9 +9,18 @@ typedef struct OpenRelTableMetaInfo{
 	char relName[ATTR_SIZE];
 } OpenRelTableMetaInfo;
 
+// Record blocks of an open relation that have a free slot, one bit per disk block. It is built from the block
+// headers of the relation on its first insert after it is opened, and kept up to date by inserts and deletes.
+typedef struct FreeSpaceMap{
+	bool valid;
+	uint64_t blocks[DISK_BLOCKS / 64];
+} FreeSpaceMap;
+
 class OpenRelTable {
 //	static char OpenRelTable[MAX_OPEN][ATTR_SIZE];
 	static OpenRelTableMetaInfo tableMetaInfo[MAX_OPEN];
+	static FreeSpaceMap freeSpaceMap[MAX_OPEN];
+	static void buildFreeSpaceMap(int relationId);
 public:
 	static void initializeOpenRelationTable();
 	static int getRelationId(char relationName[ATTR_SIZE]);
@@ -21,6 +30,8 @@ public:
 	static int checkIfRelationOpen(char relationName[ATTR_SIZE]);
 	static int checkIfRelationOpen(int relationId);
 	static int checkIfOpenRelTableHasFreeEntry();
+	static int getFreeSpaceBlock(int relationId);
+	static void setFreeSpace(int relationId, int blockNum, bool hasFreeSlot);
 };
 
 #endif //NITCBASE_OPENRELTABLE_H
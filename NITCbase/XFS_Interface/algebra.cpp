@@ -3,14 +3,19 @@
 #include <cstring>
 #include <string>
 #include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
 #include "define/constants.h"
 #include "define/errors.h"
 #include "disk_structures.h"
 #include "algebra.h"
 #include "block_access.h"
+#include "BPlusTree.h"
+#include "composite_index.h"
 #include "OpenRelTable.h"
 #include "schema.h"
 #include "external_fs_commands.h"
+#include "csv_reader.h"
 
 int checkAttrTypeOfValue(char *data);
 
@@ -20,6 +25,38 @@ void getAttrTypesForRelation(int relId, int numAttrs, int attrTypes[]);
 
 int constructRecordFromAttrsArray(int numAttrs, Attribute record[], char recordArray[][ATTR_SIZE], int attrTypes[]);
 
+int convertAttrValue(char *data, int attrType, Attribute *value);
+
+/*
+ * One input of a hash join: an open relation (a source relation or one of its partitions)
+ */
+typedef struct JoinInput {
+	int relId;
+	int numAttrs;
+	int joinOffset;
+} JoinInput;
+
+int hashJoin(JoinInput build, JoinInput probe, bool buildIsFirst, int attrType, int targetRelId);
+
+int partitionedHashJoin(JoinInput build, JoinInput probe, bool buildIsFirst, int attrType, int targetRelId, int level);
+
+int mergeJoin(JoinInput input1, int rootBlock1, JoinInput input2, int rootBlock2, int attrType, int targetRelId);
+
+int indexSelect(int srcRelId, int targetRelId, int rootBlock, int attrType, int op, Attribute val);
+
+/*
+ * A condition 'attribute op value' of a select, on the attribute at offset 'offset' of the source relation
+ */
+typedef struct SelectCondition {
+	int offset;
+	int attrType;
+	int op;
+	Attribute value;
+} SelectCondition;
+
+template<typename Visitor>
+static int scanSelectedRecords(int srcRelId, const std::vector<SelectCondition> &conditions, Visitor visit);
+
 
 int project(char srcrel[ATTR_SIZE], char targetrel[ATTR_SIZE], int tar_nAttrs, char tar_attrs[][ATTR_SIZE]) {
 	int ret;
@@ -36,10 +73,6 @@ int project(char srcrel[ATTR_SIZE], char targetrel[ATTR_SIZE], int tar_nAttrs, c
 		return E_CACHEFULL;
 	}
 
-	Attribute srcrelcatEntry[NO_OF_ATTRS_RELCAT_ATTRCAT];
-	getRelCatEntry(srcrelid, srcrelcatEntry);
-	int nAttrs = (int) srcrelcatEntry[1].nval;
-
 	int attr_offset[tar_nAttrs];
 	int attr_type[tar_nAttrs];
 	int attr_no;
@@ -69,35 +102,21 @@ int project(char srcrel[ATTR_SIZE], char targetrel[ATTR_SIZE], int tar_nAttrs, c
 //	}
 
 	/*
-	 * Get record by record from the source relation
+	 * Get record by record from the source relation, reading it block by block,
 	 *  and take the projected attributes alone for the record
 	 */
-	recId prev_recid;
-	prev_recid.block = -1;
-	prev_recid.slot = -1;
-	while (true) {
-		Attribute rec[nAttrs];
-		char attr[ATTR_SIZE];
-		Attribute val;
-		strcpy(val.sval, "PRJCT");
-		strcpy(attr, "PRJCT");
-
-		ret = ba_search(srcrelid, rec, attr, val, PRJCT, &prev_recid);
-		if (ret == SUCCESS) {
-			Attribute proj_rec[tar_nAttrs];
-			for (attr_no = 0; attr_no < tar_nAttrs; attr_no++) {
-				proj_rec[attr_no] = rec[attr_offset[attr_no]];
-			}
-			ret = ba_insert(targetRelId, proj_rec);
-			if (ret != SUCCESS) {
-				// unable to insert into target relation
-				OpenRelTable::closeRelation(targetRelId);
-				ba_delete(targetrel);
-				return ret;
-			}
-		} else
-			break;
-
+	ret = scanSelectedRecords(srcrelid, {}, [&](Attribute *rec, recId) {
+		Attribute proj_rec[tar_nAttrs];
+		for (int attr_no = 0; attr_no < tar_nAttrs; attr_no++) {
+			proj_rec[attr_no] = rec[attr_offset[attr_no]];
+		}
+		return ba_insert(targetRelId, proj_rec);
+	});
+	if (ret != SUCCESS) {
+		// unable to insert into target relation
+		OpenRelTable::closeRelation(targetRelId);
+		ba_delete(targetrel);
+		return ret;
 	}
 
 	closeRel(targetrel);
@@ -182,31 +201,481 @@ int select(char srcrel[ATTR_SIZE], char targetrel[ATTR_SIZE], char attr[ATTR_SIZ
 //		return E_CACHEFULL;
 //	}
 
-	// TODO: Already present here:
-	//  Call ba_search of block access layer with op=RST for having {-1, -1}
-	prev_recid.block = -1;
-	prev_recid.slot = -1;
-	while (true) {
-		Attribute record[nAttrs];
-		retval = ba_search(srcrelid, record, attr, val, op, &prev_recid);
-		if (retval == SUCCESS) {
-			int ret = ba_insert(targetRelId, record);
-			if (ret != SUCCESS) {
-				OpenRelTable::closeRelation(targetRelId);
-				ba_delete(targetrel);
-				return ret;
+	int rootBlock = (int) attrcat_entry[ATTRCAT_ROOT_BLOCK_INDEX].nval;
+	if (rootBlock != -1) {
+		retval = indexSelect(srcrelid, targetRelId, rootBlock, type, op, val);
+		if (retval != SUCCESS) {
+			OpenRelTable::closeRelation(targetRelId);
+			ba_delete(targetrel);
+			return retval;
+		}
+		closeRel(targetrel);
+		return SUCCESS;
+	}
+
+	/* Scan the source block by block, evaluating the condition over each block once */
+	std::vector<SelectCondition> conditions = {{(int) attrcat_entry[ATTRCAT_OFFSET_INDEX].nval, type, op, val}};
+	retval = scanSelectedRecords(srcrelid, conditions, [targetRelId](Attribute *record, recId) {
+		return ba_insert(targetRelId, record);
+	});
+	if (retval != SUCCESS) {
+		OpenRelTable::closeRelation(targetRelId);
+		ba_delete(targetrel);
+		return retval;
+	}
+	closeRel(targetrel);
+	return SUCCESS;
+}
+
+/*
+ * Inserts into the target relation every record of the source relation whose attribute, indexed by the B+ tree
+ * rooted at rootBlock, satisfies 'attribute op val'. The tree is read with range scans, so only the leaves
+ * holding matching entries are read: NE is the union of the ranges below and above val.
+ */
+int indexSelect(int srcRelId, int targetRelId, int rootBlock, int attrType, int op, Attribute val) {
+	std::vector<BPlusRangeScan> scans(op == NE ? 2 : 1, BPlusRangeScan(rootBlock, attrType));
+	switch (op) {
+		case EQ:
+			scans[0].setLowerBound(val, true);
+			scans[0].setUpperBound(val, true);
+			break;
+		case LE:
+		case LT:
+			scans[0].setUpperBound(val, op == LE);
+			break;
+		case GE:
+		case GT:
+			scans[0].setLowerBound(val, op == GE);
+			break;
+		case NE:
+			scans[0].setUpperBound(val, false);
+			scans[1].setLowerBound(val, false);
+			break;
+	}
+
+	int numAttrs = getNumberOfAttrsForRelation(srcRelId);
+	Attribute record[numAttrs];
+	Index entries[MAX_KEYS_LEAF];
+	for (auto &scan : scans) {
+		int numEntries;
+		while ((numEntries = scan.getNextBatch(entries)) > 0) {
+			for (int iter = 0; iter < numEntries; iter++) {
+				getRecord(record, entries[iter].block, entries[iter].slot);
+				int ret = ba_insert(targetRelId, record);
+				if (ret != SUCCESS)
+					return ret;
 			}
-		} else
+		}
+	}
+	return SUCCESS;
+}
+
+/*
+ * An assignment 'attribute = value' of an update, with the value converted to the type of the attribute
+ */
+typedef struct Assignment {
+	int offset;
+	Attribute value;
+} Assignment;
+
+/*
+ * The tightest bounds the conditions of a select put on one attribute, and the values they come from
+ */
+typedef struct AttrBounds {
+	bool isEqual;
+	bool hasLower, lowerInclusive;
+	bool hasUpper, upperInclusive;
+	Attribute lower, upper;
+} AttrBounds;
+
+/*
+ * A range of keys of one B+ tree covering every record that satisfies the conditions of a select
+ */
+typedef struct IndexScanPlan {
+	int rootBlock;
+	int keyType;
+	int score;
+	bool hasLower, lowerInclusive;
+	bool hasUpper, upperInclusive;
+	Attribute lower, upper;
+} IndexScanPlan;
+
+static bool satisfiesConditions(Attribute *record, const std::vector<SelectCondition> &conditions) {
+	uint64_t mask;
+	for (auto &condition : conditions) {
+		int selected;
+		if (condition.attrType == NUMBER)
+			selected = filterNumbers(record + condition.offset, 1, 1, condition.value.nval, condition.op, &mask);
+		else
+			selected = filterStrings(record + condition.offset, 1, 1, condition.value.sval, condition.op, &mask);
+		if (selected == 0)
+			return false;
+	}
+	return true;
+}
+
+static AttrBounds getAttrBounds(const std::vector<SelectCondition> &conditions, int offset) {
+	AttrBounds bounds;
+	bounds.isEqual = bounds.hasLower = bounds.hasUpper = false;
+	for (auto &condition : conditions) {
+		if (condition.offset != offset)
+			continue;
+		int attrType = condition.attrType;
+		switch (condition.op) {
+			case EQ:
+				if (!bounds.isEqual) {
+					bounds.isEqual = bounds.hasLower = bounds.hasUpper = true;
+					bounds.lowerInclusive = bounds.upperInclusive = true;
+					bounds.lower = bounds.upper = condition.value;
+				}
+				break;
+			case GT:
+			case GE:
+				if (!bounds.isEqual && (!bounds.hasLower ||
+				                        compareAttributes(condition.value, bounds.lower, attrType) > 0)) {
+					bounds.hasLower = true;
+					bounds.lowerInclusive = (condition.op == GE);
+					bounds.lower = condition.value;
+				}
+				break;
+			case LT:
+			case LE:
+				if (!bounds.isEqual && (!bounds.hasUpper ||
+				                        compareAttributes(condition.value, bounds.upper, attrType) < 0)) {
+					bounds.hasUpper = true;
+					bounds.upperInclusive = (condition.op == LE);
+					bounds.upper = condition.value;
+				}
+				break;
+		}
+	}
+	return bounds;
+}
+
+/*
+ * Picks the B+ tree, on a single attribute or a composite index, that narrows the scan of the source relation the
+ * most. It is judged by the conditions it turns into key bounds: an equality counts twice, and a bound on one side
+ * of a range once. A composite index uses equalities on a prefix of its attributes, followed by a range on the next
+ * one, and its bounds are inclusive and may be cut off, so it has to beat the single attribute trees to be picked.
+ * The records in the range picked still have to be checked against all the conditions.
+ * Returns false if no B+ tree applies to the conditions.
+ */
+static bool planIndexScan(int srcRelId, const std::vector<SelectCondition> &conditions, IndexScanPlan &plan) {
+	plan.score = 0;
+	for (auto &condition : conditions) {
+		Attribute attrCatEntry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+		getAttrCatEntry(srcRelId, condition.offset, attrCatEntry);
+		int rootBlock = (int) attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval;
+		if (rootBlock == -1)
+			continue;
+
+		AttrBounds bounds = getAttrBounds(conditions, condition.offset);
+		int score = bounds.isEqual ? 2 : (int) bounds.hasLower + (int) bounds.hasUpper;
+		if (score > plan.score) {
+			plan.rootBlock = rootBlock;
+			plan.keyType = condition.attrType;
+			plan.score = score;
+			plan.hasLower = bounds.hasLower;
+			plan.lowerInclusive = bounds.lowerInclusive;
+			plan.lower = bounds.lower;
+			plan.hasUpper = bounds.hasUpper;
+			plan.upperInclusive = bounds.upperInclusive;
+			plan.upper = bounds.upper;
+		}
+	}
+
+	std::vector<CompositeIndex> indexes;
+	getCompositeIndexes(srcRelId, indexes);
+	for (auto &index : indexes) {
+		Attribute lowerValues[COMPOSITE_INDEX_MAX_ATTRS], upperValues[COMPOSITE_INDEX_MAX_ATTRS];
+		int numEqual = 0, score = 0;
+		bool hasLower = false, hasUpper = false;
+		for (int attr = 0; attr < index.numAttrs; attr++) {
+			AttrBounds bounds = getAttrBounds(conditions, index.attrOffsets[attr]);
+			lowerValues[attr] = bounds.lower;
+			upperValues[attr] = bounds.upper;
+			if (bounds.isEqual) {
+				numEqual++;
+				score += 2;
+				continue;
+			}
+			hasLower = bounds.hasLower;
+			hasUpper = bounds.hasUpper;
+			score += (int) hasLower + (int) hasUpper;
+			break;
+		}
+		if (score <= plan.score)
+			continue;
+
+		plan.rootBlock = index.rootBlock;
+		plan.keyType = COMPOSITE;
+		plan.score = score;
+		plan.hasLower = (numEqual > 0 || hasLower);
+		plan.lowerInclusive = true;
+		encodeCompositeKey(lowerValues, index.attrTypes, numEqual + (int) hasLower, 0, &plan.lower);
+		plan.hasUpper = (numEqual > 0 || hasUpper);
+		plan.upperInclusive = true;
+		encodeCompositeKey(upperValues, index.attrTypes, numEqual + (int) hasUpper, 0xFF, &plan.upper);
+	}
+	return plan.score > 0;
+}
+
+/*
+ * Calls visit(record, recid) for every record of the source relation satisfying all the conditions,
+ * reading the source through the range of keys planned, or else block by block.
+ * Stops at, and returns, the first return value of visit other than SUCCESS.
+ */
+template<typename Visitor>
+static int scanSelectedRecords(int srcRelId, const std::vector<SelectCondition> &conditions, Visitor visit) {
+	int numAttrs = getNumberOfAttrsForRelation(srcRelId);
+
+	IndexScanPlan plan;
+	if (planIndexScan(srcRelId, conditions, plan)) {
+		BPlusRangeScan scan(plan.rootBlock, plan.keyType);
+		if (plan.hasLower)
+			scan.setLowerBound(plan.lower, plan.lowerInclusive);
+		if (plan.hasUpper)
+			scan.setUpperBound(plan.upper, plan.upperInclusive);
+
+		Attribute record[numAttrs];
+		Index entries[MAX_KEYS_LEAF];
+		int numEntries;
+		while ((numEntries = scan.getNextBatch(entries)) > 0) {
+			for (int iter = 0; iter < numEntries; iter++) {
+				getRecord(record, entries[iter].block, entries[iter].slot);
+				if (!satisfiesConditions(record, conditions))
+					continue;
+				int ret = visit(record, recId{entries[iter].block, entries[iter].slot});
+				if (ret != SUCCESS)
+					return ret;
+			}
+		}
+		return SUCCESS;
+	}
+
+	Attribute relCatEntry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+	getRelCatEntry(srcRelId, relCatEntry);
+	int block = (int) relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval;
+
+	RecordBatch batch;
+	uint64_t selected[((BLOCK_SIZE - HEADER_SIZE) / ATTR_SIZE + 63) / 64];
+	uint64_t mask[((BLOCK_SIZE - HEADER_SIZE) / ATTR_SIZE + 63) / 64];
+	while (block != -1) {
+		if (getRecordBatch(&batch, block) != SUCCESS)
 			break;
+
+		// evaluate each condition over the whole block, and keep the records satisfying all of them
+		int numWords = (batch.numRecords + 63) / 64;
+		memset(selected, 0xFF, numWords * sizeof(uint64_t));
+		for (auto &condition : conditions) {
+			if (condition.attrType == NUMBER)
+				filterNumbers(batch.records + condition.offset, batch.numRecords, numAttrs, condition.value.nval,
+				              condition.op, mask);
+			else
+				filterStrings(batch.records + condition.offset, batch.numRecords, numAttrs, condition.value.sval,
+				              condition.op, mask);
+			for (int word = 0; word < numWords; word++)
+				selected[word] &= mask[word];
+		}
+
+		for (int iter = 0; iter < batch.numRecords; iter++) {
+			if (((selected[iter / 64] >> (iter % 64)) & 1) == 0)
+				continue;
+			int ret = visit(batch.records + iter * numAttrs, recId{block, batch.slotNums[iter]});
+			if (ret != SUCCESS)
+				return ret;
+		}
+		block = batch.header.rblock;
+	}
+	return SUCCESS;
+}
+
+/*
+ * Converts the conditions 'attrs[i] ops[i] val_strs[i]' on the open relation relId to SelectConditions,
+ * with each value converted to the type of its attribute
+ */
+static int getSelectConditions(int relId, int numConditions, char attrs[][ATTR_SIZE], int ops[],
+                               char val_strs[][ATTR_SIZE], std::vector<SelectCondition> &conditions) {
+	for (int iter = 0; iter < numConditions; iter++) {
+		Attribute attrcat_entry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+		int flag = getAttrCatEntry(relId, attrs[iter], attrcat_entry);
+		if (flag != SUCCESS)
+			return flag;
+
+		SelectCondition condition;
+		condition.offset = (int) attrcat_entry[ATTRCAT_OFFSET_INDEX].nval;
+		condition.attrType = (int) attrcat_entry[ATTRCAT_ATTR_TYPE_INDEX].nval;
+		condition.op = ops[iter];
+		if (condition.attrType == NUMBER) {
+			try {
+				condition.value.nval = std::stof(val_strs[iter]);
+			} catch (std::invalid_argument &e) {
+				return E_ATTRTYPEMISMATCH;
+			}
+		} else {
+			strcpy(condition.value.sval, val_strs[iter]);
+		}
+		conditions.push_back(condition);
+	}
+	return SUCCESS;
+}
+
+/*
+ * Selects the records of the source relation satisfying all of the conditions 'attrs[i] ops[i] val_strs[i]'
+ */
+int select(char srcrel[ATTR_SIZE], char targetrel[ATTR_SIZE], int numConditions, char attrs[][ATTR_SIZE], int ops[],
+           char val_strs[][ATTR_SIZE]) {
+	/* Check source relation is open */
+	int srcrelid = OpenRelTable::getRelationId(srcrel);
+	if (srcrelid == E_RELNOTOPEN) {
+		return E_RELNOTOPEN;
+	}
+
+	int freeStatus = OpenRelTable::checkIfOpenRelTableHasFreeEntry();
+	if (freeStatus == FAILURE) {
+		std::cout << "No space in OpenRelTable to open target Rel";
+		return E_CACHEFULL;
+	}
+
+	/* Convert the values of the conditions to the types of their attributes */
+	std::vector<SelectCondition> conditions;
+	int flag = getSelectConditions(srcrelid, numConditions, attrs, ops, val_strs, conditions);
+	if (flag != SUCCESS)
+		return flag;
+
+	/* Create the target relation with the attributes of the source relation */
+	int nAttrs = getNumberOfAttrsForRelation(srcrelid);
+	char attr_names[nAttrs][ATTR_SIZE];
+	int attr_types[nAttrs];
+	for (int offset = 0; offset < nAttrs; offset++) {
+		Attribute attrcat_entry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+		getAttrCatEntry(srcrelid, offset, attrcat_entry);
+		strcpy(attr_names[offset], attrcat_entry[ATTRCAT_ATTR_NAME_INDEX].sval);
+		attr_types[offset] = (int) attrcat_entry[ATTRCAT_ATTR_TYPE_INDEX].nval;
+	}
+
+	int retval = createRel(targetrel, nAttrs, attr_names, attr_types);
+	if (retval != SUCCESS)
+		return retval;
+
+	int targetRelId = openRel(targetrel);
+	retval = scanSelectedRecords(srcrelid, conditions, [targetRelId](Attribute *record, recId) {
+		return ba_insert(targetRelId, record);
+	});
+	if (retval != SUCCESS) {
+		OpenRelTable::closeRelation(targetRelId);
+		ba_delete(targetrel);
+		return retval;
 	}
 	closeRel(targetrel);
 	return SUCCESS;
 }
 
+/*
+ * Deletes the records of the relation satisfying all of the conditions 'attrs[i] ops[i] val_strs[i]',
+ * or every record if there are none. The records are found first and then deleted one by one, as deleting
+ * them changes the B+ trees and record blocks being scanned. Deleting stops at the first record that cannot be
+ * deleted, and numDeleted is set to the number of records deleted before it.
+ * Returns SUCCESS, or an error code
+ */
+int deleteRecords(char relName[ATTR_SIZE], int numConditions, char attrs[][ATTR_SIZE], int ops[],
+                  char val_strs[][ATTR_SIZE], int *numDeleted) {
+	*numDeleted = 0;
+	if (strcmp(relName, RELCAT_RELNAME) == 0 || strcmp(relName, ATTRCAT_RELNAME) == 0 ||
+	    strcmp(relName, INDEXCAT_RELNAME) == 0) {
+		std::cout << "Delete operation not permitted for Relation Catalog, Attribute Catalog or Index Catalog" << std::endl;
+		return E_NOTPERMITTED;
+	}
+
+	int relId = OpenRelTable::getRelationId(relName);
+	if (relId == E_RELNOTOPEN) {
+		return E_RELNOTOPEN;
+	}
+
+	std::vector<SelectCondition> conditions;
+	int flag = getSelectConditions(relId, numConditions, attrs, ops, val_strs, conditions);
+	if (flag != SUCCESS)
+		return flag;
+
+	std::vector<recId> recIds;
+	scanSelectedRecords(relId, conditions, [&recIds](Attribute *, recId recid) {
+		recIds.push_back(recid);
+		return SUCCESS;
+	});
+
+	for (auto &recid : recIds) {
+		int ret = ba_deleteRecord(relId, recid);
+		if (ret != SUCCESS)
+			return ret;
+		(*numDeleted)++;
+	}
+	return SUCCESS;
+}
+
+/*
+ * Sets the attributes setAttrs[i] to set_val_strs[i] in the records of the relation satisfying all of the conditions
+ * 'attrs[i] ops[i] val_strs[i]', or in every record if there are none. The records are updated in place after
+ * they are all found, so that a record whose indexed attribute moves forward in a B+ tree is not updated twice.
+ * Returns the number of records updated, or an error code
+ */
+int updateRecords(char relName[ATTR_SIZE], int numAssignments, char setAttrs[][ATTR_SIZE],
+                  char set_val_strs[][ATTR_SIZE], int numConditions, char attrs[][ATTR_SIZE], int ops[],
+                  char val_strs[][ATTR_SIZE]) {
+	if (strcmp(relName, RELCAT_RELNAME) == 0 || strcmp(relName, ATTRCAT_RELNAME) == 0 ||
+	    strcmp(relName, INDEXCAT_RELNAME) == 0) {
+		std::cout << "Update operation not permitted for Relation Catalog, Attribute Catalog or Index Catalog" << std::endl;
+		return E_NOTPERMITTED;
+	}
+
+	int relId = OpenRelTable::getRelationId(relName);
+	if (relId == E_RELNOTOPEN) {
+		return E_RELNOTOPEN;
+	}
+
+	/* The values assigned are converted to the types of their attributes the same way as the values inserted */
+	std::vector<Assignment> assignments(numAssignments);
+	for (int iter = 0; iter < numAssignments; iter++) {
+		Attribute attrcat_entry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+		int flag = getAttrCatEntry(relId, setAttrs[iter], attrcat_entry);
+		if (flag != SUCCESS)
+			return flag;
+		assignments[iter].offset = (int) attrcat_entry[ATTRCAT_OFFSET_INDEX].nval;
+		flag = convertAttrValue(set_val_strs[iter], (int) attrcat_entry[ATTRCAT_ATTR_TYPE_INDEX].nval,
+		                        &assignments[iter].value);
+		if (flag != SUCCESS)
+			return flag;
+	}
+
+	std::vector<SelectCondition> conditions;
+	int flag = getSelectConditions(relId, numConditions, attrs, ops, val_strs, conditions);
+	if (flag != SUCCESS)
+		return flag;
+
+	std::vector<recId> recIds;
+	scanSelectedRecords(relId, conditions, [&recIds](Attribute *, recId recid) {
+		recIds.push_back(recid);
+		return SUCCESS;
+	});
+
+	Attribute relCatEntry[RELCAT_NO_ATTRS];
+	getRelCatEntry(relId, relCatEntry);
+	Attribute record[(int) relCatEntry[RELCAT_NO_ATTRIBUTES_INDEX].nval];
+	for (auto &recid : recIds) {
+		getRecord(record, recid.block, recid.slot);
+		for (auto &assignment : assignments)
+			record[assignment.offset] = assignment.value;
+		int ret = ba_updateRecord(relId, recid, record);
+		if (ret != SUCCESS)
+			return ret;
+	}
+	return (int) recIds.size();
+}
+
 int insert(std::vector<std::string> attributeTokens, char *table_name) {
 
-	if (strcmp(table_name, "RELATIONCAT") == 0 || strcmp(table_name, "ATTRIBUTECAT") == 0) {
-		std::cout << "Insert operation not permitted for Relation Catalog or Attribute Catalog" << std::endl;
+	if (strcmp(table_name, "RELATIONCAT") == 0 || strcmp(table_name, "ATTRIBUTECAT") == 0 ||
+	    strcmp(table_name, INDEXCAT_RELNAME) == 0) {
+		std::cout << "Insert operation not permitted for Relation Catalog, Attribute Catalog or Index Catalog" << std::endl;
 		return E_INVALID;
 	}
 
@@ -255,14 +724,18 @@ int insert(std::vector<std::string> attributeTokens, char *table_name) {
 	return retValue;
 }
 
+/*
+ * Inserts the records of a CSV file into the relation as one bulk insert: the file is read through a CSVReader and
+ * records are parsed into batches of about INSERT_BATCH_SIZE bytes that are written into whole record blocks, and
+ * the indexes of the relation get the entries of all the records at the end, also when a line of the file is rejected
+ */
 int insert(char relName[ATTR_SIZE], char *fileName) {
 
-	if (strcmp(relName, "RELATIONCAT") == 0 || strcmp(relName, "ATTRIBUTECAT") == 0) {
+	if (strcmp(relName, "RELATIONCAT") == 0 || strcmp(relName, "ATTRIBUTECAT") == 0 ||
+	    strcmp(relName, INDEXCAT_RELNAME) == 0) {
 		return E_INVALID;
 	}
 
-	int currentCharacter;
-
 	// check if relation is open
 	int relId = OpenRelTable::getRelationId(relName);
 	if (relId == E_RELNOTOPEN) {
@@ -276,100 +749,73 @@ int insert(char relName[ATTR_SIZE], char *fileName) {
 	int attrTypes[numOfAttributes];
 	getAttrTypesForRelation(relId, numOfAttributes, attrTypes);
 
-
-	char *currentLineAsCharArray = (char *) malloc(sizeof(char));
-	int numOfCharactersInLine = 1;
-
-	FILE *file = fopen(fileName, "r");
+	BulkInsert bulk;
+	int retValue = ba_beginBulkInsert(relId, &bulk);
+	if (retValue != SUCCESS)
+		return retValue;
+	int batchCapacity = std::max(1, INSERT_BATCH_SIZE / (numOfAttributes * ATTR_SIZE));
+	std::vector<Attribute> batch(batchCapacity * numOfAttributes);
+	int numOfRecordsInBatch = 0;
+
+	CSVReader reader;
+	if (reader.open(fileName) != SUCCESS)
+		retValue = FAILURE;
+	char attributesCharArray[numOfAttributes][ATTR_SIZE];
+	char *line;
+	int lineLength;
 	int lineNumber = 1;
-	while (true) {
-		currentCharacter = fgetc(file);
-		if (currentCharacter == EOF)
-			break;
-		while (currentCharacter == ' ' || currentCharacter == '\t' || currentCharacter == '\n') {
-			currentCharacter = fgetc(file);
-		}
-		if (currentCharacter == EOF)
-			break;
-
-		numOfCharactersInLine = 1;
-		int numOfFieldsInLine = 0;
-
-		char previousCharacter = ',';
-		while ((currentCharacter != '\n') && (currentCharacter != EOF)) {
-			if (currentCharacter == ',')
-				numOfFieldsInLine++;
-
-			if (previousCharacter == currentCharacter && currentCharacter == ',') {
+	while (retValue == SUCCESS && (lineLength = reader.readLine(&line, true)) != FAILURE) {
+		int numOfFieldsInLine = splitCSVLine(line, lineLength, numOfAttributes, attributesCharArray);
+		if (numOfFieldsInLine == FAILURE) {
+			if (line[lineLength - 1] == ',')
+				std::cout << "Null values not allowed in attribute values\n";
+			else
 				std::cout << "Null values not allowed\n";
-				return FAILURE;
-			}
-
-			currentLineAsCharArray[numOfCharactersInLine - 1] = currentCharacter;
-			numOfCharactersInLine++;
-			currentLineAsCharArray = (char *) realloc(currentLineAsCharArray, (numOfCharactersInLine) * sizeof(char));
-			previousCharacter = currentCharacter;
-			currentCharacter = fgetc(file);
-
-		}
-
-		if (previousCharacter == ',') {
-			std::cout << "Null values not allowed in attribute values\n";
-			return FAILURE;
+			retValue = FAILURE;
+			break;
 		}
 
-		if (numOfAttributes != numOfFieldsInLine + 1) {
+		if (numOfAttributes != numOfFieldsInLine) {
 			std::cout << "Mismatch in number of attributes\n";
-			return FAILURE;
-		}
-		currentLineAsCharArray[numOfCharactersInLine - 1] = '\0';
-		int currentCharIndexInLine = 0;
-
-		char attributesCharArray[numOfAttributes][ATTR_SIZE];
-		int attrOffsetIterator = 0;
-
-		while (attrOffsetIterator < numOfAttributes) {
-			int attributeIndexIterator = 0;
-
-			while (((currentLineAsCharArray[currentCharIndexInLine] != ',') &&
-			        (currentLineAsCharArray[currentCharIndexInLine] != '\0')) && (attributeIndexIterator < 15)) {
-				attributesCharArray[attrOffsetIterator][attributeIndexIterator++] = currentLineAsCharArray[currentCharIndexInLine++];
-			}
-			if (attributeIndexIterator == 15) {
-				while (currentLineAsCharArray[currentCharIndexInLine] != ',')
-					currentCharIndexInLine++;
-			}
-			currentCharIndexInLine++;
-			attributesCharArray[attrOffsetIterator][attributeIndexIterator] = '\0';
-			attrOffsetIterator++;
+			retValue = FAILURE;
+			break;
 		}
 
-		Attribute record[numOfAttributes];
-		int retValue = constructRecordFromAttrsArray(numOfAttributes, record, attributesCharArray, attrTypes);
+		Attribute *record = &batch[numOfRecordsInBatch * numOfAttributes];
+		retValue = constructRecordFromAttrsArray(numOfAttributes, record, attributesCharArray, attrTypes);
 		if (retValue == E_ATTRTYPEMISMATCH)
-			return E_ATTRTYPEMISMATCH;
+			break;
 		else if (retValue == E_INVALID) {
 			if (lineNumber > 1) {
 				std::cout << "Rows till line " << lineNumber - 1 << " successfully inserted\n";
 			}
 			std::cout << "Invalid character at line " << lineNumber << " in file \n";
 			std::cout << "Subsequent lines will be skipped\n";
-			return FAILURE;
+			retValue = FAILURE;
+			break;
 		}
 
-		retValue = ba_insert(relId, record);
-		if (retValue != SUCCESS) {
-			return retValue;
+		numOfRecordsInBatch++;
+		if (numOfRecordsInBatch == batchCapacity) {
+			retValue = ba_bulkInsert(&bulk, batch.data(), numOfRecordsInBatch);
+			numOfRecordsInBatch = 0;
+			if (retValue != SUCCESS)
+				break;
 		}
 
-		if (currentCharacter == EOF)
-			break;
-
 		lineNumber++;
 	}
 
-	fclose(file);
-	return SUCCESS;
+	// the lines read before a rejected line are inserted, as they would have been one by one
+	if (numOfRecordsInBatch > 0) {
+		int ret = ba_bulkInsert(&bulk, batch.data(), numOfRecordsInBatch);
+		if (retValue == SUCCESS)
+			retValue = ret;
+	}
+	int ret = ba_endBulkInsert(&bulk);
+	if (retValue == SUCCESS)
+		retValue = ret;
+	return retValue;
 }
 
 int join(char srcrel1[ATTR_SIZE], char srcrel2[ATTR_SIZE], char targetRelation[ATTR_SIZE], char attr1[ATTR_SIZE],
@@ -464,57 +910,742 @@ int join(char srcrel1[ATTR_SIZE], char srcrel2[ATTR_SIZE], char targetRelation[A
 		return E_CACHEFULL;
 	}
 
-	Attribute record1[nAttrs1];
-	recId prev_recid1;
-	prev_recid1.block = -1;
-	prev_recid1.slot = -1;
-	Attribute dummy;
-	strcpy(dummy.sval, " ");
-
 	// FORMING TARGET RELATION
 	/*
-	 *
+	 * If both join attributes have a B+ tree, sort-merge join along their leaf chains. With only one index, the
+	 * records would still have to be read in key order one leaf at a time and the other input sorted, which costs
+	 * more than hashing, so the index is not used.
+	 * Otherwise hash join: build a hash table on the join attribute of the smaller relation and probe it with every
+	 * record of the other. If the build side does not fit in JOIN_MEMORY_SIZE, both relations are first
+	 * split by the hash of the join attribute into partitions, which are joined pair by pair (see partitionedHashJoin).
 	 */
-	while (ba_search(srcRelId1, record1, "PROJECT", dummy, PRJCT, &prev_recid1) == SUCCESS) {
-
-		Attribute record2[nAttrs2];
-		Attribute targetRecord[nAttrs1 + nAttrs2 - 1];
-		recId prev_recid2;
-		prev_recid2.block = -1;
-		prev_recid2.slot = -1;
-
-		while (ba_search(srcRelId2, record2, attr2, record1[static_cast<int>(attrcat_entry1[5].nval)], EQ,
-		                 &prev_recid2) == SUCCESS) {
-
-			for (int iter = 0; iter < nAttrs1; iter++)
-				targetRecord[iter] = record1[iter];
-			int targetIndex = nAttrs1;
-			for (int iter = 0; iter < nAttrs2; iter++) {
-				if (iter != static_cast<int>(attrcat_entry2[5].nval))
-					targetRecord[targetIndex++] = record2[iter];
-			}
+	JoinInput input1 = {srcRelId1, nAttrs1, static_cast<int>(attrcat_entry1[5].nval)};
+	JoinInput input2 = {srcRelId2, nAttrs2, static_cast<int>(attrcat_entry2[5].nval)};
+	int attrType = static_cast<int>(attrcat_entry1[2].nval);
+	double size1 = relcat_entry1[2].nval * nAttrs1 * ATTR_SIZE;
+	double size2 = relcat_entry2[2].nval * nAttrs2 * ATTR_SIZE;
+
+	int rootBlock1 = static_cast<int>(attrcat_entry1[ATTRCAT_ROOT_BLOCK_INDEX].nval);
+	int rootBlock2 = static_cast<int>(attrcat_entry2[ATTRCAT_ROOT_BLOCK_INDEX].nval);
 
-			flag = ba_insert(targetRelId, targetRecord);
+	bool buildIsFirst = (size1 < size2);
+
+	if (rootBlock1 != -1 && rootBlock2 != -1)
+		flag = mergeJoin(input1, rootBlock1, input2, rootBlock2, attrType, targetRelId);
+	else if (buildIsFirst)
+		flag = partitionedHashJoin(input1, input2, true, attrType, targetRelId, 0);
+	else
+		flag = partitionedHashJoin(input2, input1, false, attrType, targetRelId, 0);
+
+	if (flag != SUCCESS) {
+		OpenRelTable::closeRelation(targetRelId);
+		deleteRel(targetRelation);
+		return flag;
+	}
 
-			if (flag != SUCCESS) {
-				OpenRelTable::closeRelation(targetRelId);
-				deleteRel(targetRelation);
-				return flag;
+	OpenRelTable::closeRelation(targetRelId);
+	return SUCCESS;
+}
+
+/*
+ * Reads every record block of the relation in turn and calls visit(record, recid) for each of its records.
+ * Stops at, and returns, the first return value of visit other than SUCCESS.
+ */
+template<typename Visitor>
+static int scanRelation(int relId, Visitor visit) {
+	Attribute relCatEntry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+	getRelCatEntry(relId, relCatEntry);
+	int curr_block = static_cast<int>(relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval);
+
+	RecordBatch batch;
+	while (curr_block != -1) {
+		if (getRecordBatch(&batch, curr_block) != SUCCESS)
+			break;
+		for (int iter = 0; iter < batch.numRecords; iter++) {
+			int ret = visit(batch.records + iter * batch.header.numAttrs, recId{curr_block, batch.slotNums[iter]});
+			if (ret != SUCCESS)
+				return ret;
+		}
+		curr_block = batch.header.rblock;
+	}
+	return SUCCESS;
+}
+
+/*
+ * Gets the key of a join attribute value in the hash table: the 8 bytes of a NUMBER or the characters of a STRING.
+ * Returns false for a NaN, which is not equal to (and so joins with) anything.
+ */
+static bool getJoinKey(Attribute value, int attrType, std::string &key) {
+	if (attrType == NUMBER) {
+		if (value.nval != value.nval)
+			return false;
+		// -0 and 0 compare equal, so they must have the same key
+		double number = (value.nval == 0) ? 0.0 : value.nval;
+		key.assign(reinterpret_cast<char *>(&number), sizeof(number));
+	} else {
+		key.assign(value.sval, strnlen(value.sval, ATTR_SIZE));
+	}
+	return true;
+}
+
+/*
+ * Partition of a join key when splitting at the given level (0 for the source relations, one more for each time
+ * a partition is split again). Uses the high 24 bits of the hash, the hash table of each partition uses the low
+ * ones; every level takes the next base JOIN_MAX_PARTITIONS digit of them, so that keys which shared a partition
+ * at one level are spread at the next.
+ */
+static int getJoinPartition(const std::string &key, int numPartitions, int level) {
+	uint64_t bits = std::hash<std::string>()(key) >> 40;
+	for (int iter = 0; iter < level; iter++)
+		bits /= JOIN_MAX_PARTITIONS;
+	return static_cast<int>(bits % numPartitions);
+}
+
+/*
+ * Number of records in an open relation
+ */
+static int getNumRecords(int relId) {
+	Attribute relCatEntry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+	getRelCatEntry(relId, relCatEntry);
+	return static_cast<int>(relCatEntry[RELCAT_NO_RECORDS_INDEX].nval);
+}
+
+/*
+ * Inserts the record made of all attributes of record1 followed by those of record2 other than its
+ * join attribute into the target relation
+ */
+static int insertJoinedRecord(int targetRelId, JoinInput first, Attribute *record1, JoinInput second,
+                              Attribute *record2) {
+	Attribute targetRecord[first.numAttrs + second.numAttrs - 1];
+	for (int iter = 0; iter < first.numAttrs; iter++)
+		targetRecord[iter] = record1[iter];
+	int targetIndex = first.numAttrs;
+	for (int iter = 0; iter < second.numAttrs; iter++) {
+		if (iter != second.joinOffset)
+			targetRecord[targetIndex++] = record2[iter];
+	}
+	return ba_insert(targetRelId, targetRecord);
+}
+
+/*
+ * Joins the build and probe inputs with an in-memory hash table on the join attribute of the build side,
+ * inserting the joined records into the target relation.
+ * buildIsFirst tells if the build side is the first relation of the join, whose attributes come first in the
+ * target record and whose join attribute is kept.
+ */
+int hashJoin(JoinInput build, JoinInput probe, bool buildIsFirst, int attrType, int targetRelId) {
+	std::vector<Attribute> buildRecords;
+	std::unordered_map<std::string, std::vector<int>> hashTable;
+	std::string key;
+
+	scanRelation(build.relId, [&](Attribute *record, recId) {
+		if (getJoinKey(record[build.joinOffset], attrType, key)) {
+			hashTable[key].push_back(buildRecords.size() / build.numAttrs);
+			buildRecords.insert(buildRecords.end(), record, record + build.numAttrs);
+		}
+		return SUCCESS;
+	});
+
+	JoinInput first = buildIsFirst ? build : probe;
+	JoinInput second = buildIsFirst ? probe : build;
+
+	return scanRelation(probe.relId, [&](Attribute *probeRecord, recId) {
+		if (!getJoinKey(probeRecord[probe.joinOffset], attrType, key))
+			return SUCCESS;
+		auto match = hashTable.find(key);
+		if (match == hashTable.end())
+			return SUCCESS;
+
+		for (int buildIndex : match->second) {
+			Attribute *buildRecord = &buildRecords[buildIndex * build.numAttrs];
+			Attribute *record1 = buildIsFirst ? buildRecord : probeRecord;
+			Attribute *record2 = buildIsFirst ? probeRecord : buildRecord;
+
+			int ret = insertJoinedRecord(targetRelId, first, record1, second, record2);
+			if (ret != SUCCESS)
+				return ret;
+		}
+		return SUCCESS;
+	});
+}
+
+/*
+ * Closes and deletes the partition relations 'names[0]' to 'names[numPartitions - 1]'
+ */
+static void deletePartitions(char names[][ATTR_SIZE], int numPartitions) {
+	for (int iter = 0; iter < numPartitions; iter++) {
+		int relId = OpenRelTable::getRelationId(names[iter]);
+		if (relId != E_RELNOTOPEN)
+			OpenRelTable::closeRelation(relId);
+		deleteRel(names[iter]);
+	}
+}
+
+/*
+ * Splits the input into numPartitions temporary relations named JOIN_PARTITION_PREFIX<side><level>_<partition>,
+ * by the hash of the join attribute, and fills 'names' with their names.
+ * The partitions are closed on return. On failure, those already created are deleted.
+ */
+static int partitionRelation(JoinInput input, int attrType, char side, int level, int numPartitions,
+                             char names[][ATTR_SIZE]) {
+	char attrNames[input.numAttrs][ATTR_SIZE];
+	int attrTypes[input.numAttrs];
+	for (int iter = 0; iter < input.numAttrs; iter++) {
+		Attribute attrCatEntry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+		getAttrCatEntry(input.relId, iter, attrCatEntry);
+		strcpy(attrNames[iter], attrCatEntry[ATTRCAT_ATTR_NAME_INDEX].sval);
+		attrTypes[iter] = static_cast<int>(attrCatEntry[ATTRCAT_ATTR_TYPE_INDEX].nval);
+	}
+
+	int partitionRelIds[numPartitions];
+	for (int iter = 0; iter < numPartitions; iter++) {
+		char fullName[32];
+		int ret = E_MAXRELATIONS;
+		if (snprintf(fullName, sizeof(fullName), "%s%c%d_%d", JOIN_PARTITION_PREFIX, side, level, iter) < ATTR_SIZE) {
+			strcpy(names[iter], fullName);
+			ret = createRel(names[iter], input.numAttrs, attrNames, attrTypes);
+		}
+		if (ret == SUCCESS) {
+			ret = OpenRelTable::openRelation(names[iter]);
+			if (ret < 0) {
+				deletePartitions(names, iter + 1);
+				return ret;
 			}
+			partitionRelIds[iter] = ret;
+		} else {
+			deletePartitions(names, iter);
+			return ret;
+		}
+	}
+
+	std::string key;
+	int ret = scanRelation(input.relId, [&](Attribute *record, recId) {
+		if (!getJoinKey(record[input.joinOffset], attrType, key))
+			return SUCCESS;
+		return ba_insert(partitionRelIds[getJoinPartition(key, numPartitions, level)], record);
+	});
+	if (ret != SUCCESS) {
+		deletePartitions(names, numPartitions);
+		return ret;
+	}
+
+	for (int iter = 0; iter < numPartitions; iter++)
+		OpenRelTable::closeRelation(partitionRelIds[iter]);
+	return SUCCESS;
+}
+
+/*
+ * Joins the build and probe inputs with hashJoin. If the build side is larger than JOIN_MEMORY_SIZE, both are
+ * first split into as many pairs of partitions as it takes for each build partition to fit, at most
+ * JOIN_MAX_PARTITIONS per pass since every partition of an input is open while it is split. A build partition
+ * that still does not fit is split again at the next level, so only JOIN_MEMORY_SIZE of the build side is in
+ * memory at a time. The exception is a partition that splitting no longer makes smaller, because its records
+ * share a join value or the hash bits have run out; it is joined in memory as a whole.
+ * level is 0 for the source relations. At higher levels the inputs are partitions themselves, which are closed
+ * once they have been split to keep the number of open relations the same at every level.
+ * If the partitions cannot be created (no room in the relation catalog or the open relation table),
+ * the inputs are joined in memory as a whole.
+ */
+int partitionedHashJoin(JoinInput build, JoinInput probe, bool buildIsFirst, int attrType, int targetRelId, int level) {
+	int buildRecords = getNumRecords(build.relId);
+	double buildSize = static_cast<double>(buildRecords) * build.numAttrs * ATTR_SIZE;
+	int numPartitions = static_cast<int>((buildSize + JOIN_MEMORY_SIZE - 1) / JOIN_MEMORY_SIZE);
+	if (numPartitions > JOIN_MAX_PARTITIONS)
+		numPartitions = JOIN_MAX_PARTITIONS;
+	if (numPartitions <= 1)
+		return hashJoin(build, probe, buildIsFirst, attrType, targetRelId);
+
+	char buildNames[numPartitions][ATTR_SIZE];
+	char probeNames[numPartitions][ATTR_SIZE];
+	if (partitionRelation(build, attrType, 'b', level, numPartitions, buildNames) != SUCCESS)
+		return hashJoin(build, probe, buildIsFirst, attrType, targetRelId);
+	if (partitionRelation(probe, attrType, 'p', level, numPartitions, probeNames) != SUCCESS) {
+		deletePartitions(buildNames, numPartitions);
+		return hashJoin(build, probe, buildIsFirst, attrType, targetRelId);
+	}
+	if (level > 0) {
+		OpenRelTable::closeRelation(build.relId);
+		OpenRelTable::closeRelation(probe.relId);
+	}
 
+	int ret = SUCCESS;
+	for (int iter = 0; iter < numPartitions && ret == SUCCESS; iter++) {
+		JoinInput buildPartition = build;
+		JoinInput probePartition = probe;
+		buildPartition.relId = OpenRelTable::openRelation(buildNames[iter]);
+		probePartition.relId = OpenRelTable::openRelation(probeNames[iter]);
+		if (buildPartition.relId < 0 || probePartition.relId < 0)
+			ret = E_CACHEFULL;
+		else if (getNumRecords(buildPartition.relId) < buildRecords)
+			ret = partitionedHashJoin(buildPartition, probePartition, buildIsFirst, attrType, targetRelId, level + 1);
+		else
+			ret = hashJoin(buildPartition, probePartition, buildIsFirst, attrType, targetRelId);
+		deletePartitions(buildNames + iter, 1);
+		deletePartitions(probeNames + iter, 1);
+	}
+
+	if (ret != SUCCESS) {
+		deletePartitions(buildNames, numPartitions);
+		deletePartitions(probeNames, numPartitions);
+	}
+	return ret;
+}
+
+/*
+ * Position of an external sort in one of its sorted runs, read one record block at a time
+ */
+typedef struct RunCursor {
+	RecordBatch batch;
+	int position;
+	bool exhausted;
+} RunCursor;
+
+static void nextRunRecord(RunCursor &cursor) {
+	cursor.position++;
+	while (cursor.position >= cursor.batch.numRecords) {
+		int nextBlock = cursor.batch.header.rblock;
+		if (nextBlock == -1 || getRecordBatch(&cursor.batch, nextBlock) != SUCCESS) {
+			cursor.exhausted = true;
+			return;
 		}
+		cursor.position = 0;
 	}
+}
 
-	OpenRelTable::closeRelation(targetRelId);
+static void openRunCursor(RunCursor &cursor, int firstBlock) {
+	cursor.exhausted = (firstBlock == -1 || getRecordBatch(&cursor.batch, firstBlock) != SUCCESS);
+	cursor.position = -1;
+	if (!cursor.exhausted)
+		nextRunRecord(cursor);
+}
+
+static Attribute *getRunRecord(RunCursor &cursor) {
+	return cursor.batch.records + cursor.position * cursor.batch.header.numAttrs;
+}
+
+/*
+ * Schema of the relation being sorted, shared by its runs and the sorted relation
+ */
+typedef struct SortInfo {
+	int numAttrs;
+	int keyOffset;
+	int keyType;
+	int order;
+	std::vector<std::string> attrNames;
+	std::vector<int> attrTypes;
+} SortInfo;
+
+/*
+ * Creates a relation with the schema of the relation being sorted and opens it
+ * Returns its relation id or an error code
+ */
+static int createSortRelation(const SortInfo &info, char relName[ATTR_SIZE]) {
+	char attrNames[info.numAttrs][ATTR_SIZE];
+	int attrTypes[info.numAttrs];
+	for (int iter = 0; iter < info.numAttrs; iter++) {
+		strcpy(attrNames[iter], info.attrNames[iter].c_str());
+		attrTypes[iter] = info.attrTypes[iter];
+	}
+
+	int ret = createRel(relName, info.numAttrs, attrNames, attrTypes);
+	if (ret != SUCCESS)
+		return ret;
+	ret = OpenRelTable::openRelation(relName);
+	if (ret < 0)
+		deleteRel(relName);
+	return ret;
+}
+
+static int getFirstBlock(char relName[ATTR_SIZE]) {
+	int relId = OpenRelTable::openRelation(relName);
+	if (relId < 0)
+		return relId;
+	Attribute relCatEntry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+	getRelCatEntry(relId, relCatEntry);
+	OpenRelTable::closeRelation(relId);
+	return static_cast<int>(relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval);
+}
+
+/*
+ * Sorts the records in memory and writes them to a new relation 'relName'
+ * The sort is stable, so records with equal keys keep the order in which they were read.
+ */
+static int writeSortedRun(const SortInfo &info, std::vector<Attribute> &records, char relName[ATTR_SIZE]) {
+	int numRecords = records.size() / info.numAttrs;
+	std::vector<int> order(numRecords);
+	for (int iter = 0; iter < numRecords; iter++)
+		order[iter] = iter;
+	std::stable_sort(order.begin(), order.end(), [&](int record1, int record2) {
+		return compareSortKeys(records[record1 * info.numAttrs + info.keyOffset],
+		                       records[record2 * info.numAttrs + info.keyOffset], info.keyType, info.order) < 0;
+	});
+
+	int relId = createSortRelation(info, relName);
+	if (relId < 0)
+		return relId;
+	for (int iter = 0; iter < numRecords; iter++) {
+		int ret = ba_insert(relId, &records[order[iter] * info.numAttrs]);
+		if (ret != SUCCESS) {
+			OpenRelTable::closeRelation(relId);
+			deleteRel(relName);
+			return ret;
+		}
+	}
+	OpenRelTable::closeRelation(relId);
 	return SUCCESS;
 }
 
-int checkAttrTypeOfValue(char *data) {
-	int len;
-	float ignore;
+/*
+ * Tells if the current record of run1 goes before that of run2 in the merge.
+ * numRuns stands for a virtual run that goes before everything (used to build the loser tree),
+ * an exhausted run goes after everything, and a tie goes to the earlier run to keep the sort stable.
+ */
+static bool runGoesFirst(std::vector<RunCursor> &cursors, const SortInfo &info, int run1, int run2) {
+	int numRuns = cursors.size();
+	if (run1 == numRuns || run2 == numRuns)
+		return run1 == numRuns;
+	if (cursors[run1].exhausted || cursors[run2].exhausted)
+		return !cursors[run1].exhausted;
+	int flag = compareSortKeys(getRunRecord(cursors[run1])[info.keyOffset],
+	                           getRunRecord(cursors[run2])[info.keyOffset], info.keyType, info.order);
+	return flag != 0 ? flag < 0 : run1 < run2;
+}
 
-	int ret = sscanf(data, "%f %n", &ignore, &len);
-	if (ret == 1 && len == strlen(data)) {
+/*
+ * Replays the matches on the path from the leaf of 'run' to the root of the loser tree, leaving the loser of
+ * each match in its node and the overall winner in losers[0]
+ */
+static void replayLoserTree(std::vector<int> &losers, std::vector<RunCursor> &cursors, const SortInfo &info, int run) {
+	int numRuns = cursors.size();
+	for (int node = (run + numRuns) / 2; node > 0; node /= 2) {
+		if (runGoesFirst(cursors, info, losers[node], run))
+			std::swap(run, losers[node]);
+	}
+	losers[0] = run;
+}
+
+/*
+ * Merges the sorted runs into a new relation 'relName' with a loser tree, which picks the next record with
+ * one comparison per level of the tree. The runs are read block by block and deleted afterwards.
+ */
+static int mergeSortedRuns(const SortInfo &info, std::vector<std::string> &runs, char relName[ATTR_SIZE]) {
+	int numRuns = runs.size();
+	std::vector<RunCursor> cursors(numRuns);
+	for (int iter = 0; iter < numRuns; iter++) {
+		char runName[ATTR_SIZE];
+		strcpy(runName, runs[iter].c_str());
+		int firstBlock = getFirstBlock(runName);
+		if (firstBlock < -1)
+			return firstBlock;
+		openRunCursor(cursors[iter], firstBlock);
+	}
+
+	int relId = createSortRelation(info, relName);
+	if (relId < 0)
+		return relId;
+
+	std::vector<int> losers(numRuns, numRuns);
+	for (int run = numRuns - 1; run >= 0; run--)
+		replayLoserTree(losers, cursors, info, run);
+
+	int ret = SUCCESS;
+	while (!cursors[losers[0]].exhausted) {
+		int run = losers[0];
+		ret = ba_insert(relId, getRunRecord(cursors[run]));
+		if (ret != SUCCESS)
+			break;
+		nextRunRecord(cursors[run]);
+		replayLoserTree(losers, cursors, info, run);
+	}
+	OpenRelTable::closeRelation(relId);
+
+	if (ret != SUCCESS) {
+		deleteRel(relName);
+		return ret;
+	}
+	for (int iter = 0; iter < numRuns; iter++) {
+		char runName[ATTR_SIZE];
+		strcpy(runName, runs[iter].c_str());
+		deleteRel(runName);
+	}
+	return SUCCESS;
+}
+
+/*
+ * Sorts the records of the open relation srcRelId on the attribute at keyOffset into a new relation 'targetRel'
+ * with the same schema, which is left closed. The sort is stable.
+ *
+ * Runs of up to SORT_MEMORY_SIZE bytes of records are sorted in memory and written to temporary relations
+ * named SORT_RUN_PREFIX<number>. Runs are merged SORT_MERGE_FANIN at a time as soon as that many runs of the
+ * same level exist, which bounds the number of temporary relations (and so of Relation Catalog entries) in use.
+ * If the whole relation fits in memory, it is written to targetRel directly.
+ */
+int externalSort(int srcRelId, char targetRel[ATTR_SIZE], int keyOffset, int order) {
+	SortInfo info;
+	info.numAttrs = getNumberOfAttrsForRelation(srcRelId);
+	info.keyOffset = keyOffset;
+	info.order = order;
+	for (int iter = 0; iter < info.numAttrs; iter++) {
+		Attribute attrCatEntry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+		getAttrCatEntry(srcRelId, iter, attrCatEntry);
+		info.attrNames.push_back(attrCatEntry[ATTRCAT_ATTR_NAME_INDEX].sval);
+		info.attrTypes.push_back(static_cast<int>(attrCatEntry[ATTRCAT_ATTR_TYPE_INDEX].nval));
+	}
+	info.keyType = info.attrTypes[keyOffset];
+
+	size_t recordsPerRun = SORT_MEMORY_SIZE / (info.numAttrs * ATTR_SIZE);
+	if (recordsPerRun == 0)
+		recordsPerRun = 1;
+
+	// levels[l] holds the runs made by merging SORT_MERGE_FANIN runs of level l - 1, oldest first
+	std::vector<std::vector<std::string>> levels;
+	int runCount = 0;
+	char runName[ATTR_SIZE];
+	// names a new run in runName and name, failing if the name does not fit in a relation name
+	auto newRunName = [&](std::string &name) {
+		char fullName[32];
+		if (snprintf(fullName, sizeof(fullName), "%s%d", SORT_RUN_PREFIX, runCount++) >= ATTR_SIZE)
+			return E_MAXRELATIONS;
+		strcpy(runName, fullName);
+		name = runName;
+		return SUCCESS;
+	};
+	auto deleteAllRuns = [&]() {
+		for (auto &level : levels) {
+			for (auto &run : level) {
+				strcpy(runName, run.c_str());
+				deleteRel(runName);
+			}
+		}
+	};
+
+	std::vector<Attribute> records;
+	auto flushRun = [&]() {
+		std::string name;
+		int ret = newRunName(name);
+		if (ret == SUCCESS)
+			ret = writeSortedRun(info, records, runName);
+		records.clear();
+		if (ret != SUCCESS)
+			return ret;
+		if (levels.empty())
+			levels.emplace_back();
+		levels[0].push_back(name);
+
+		for (size_t level = 0; levels[level].size() == SORT_MERGE_FANIN; level++) {
+			std::string merged;
+			ret = newRunName(merged);
+			if (ret == SUCCESS)
+				ret = mergeSortedRuns(info, levels[level], runName);
+			if (ret != SUCCESS)
+				return ret;
+			levels[level].clear();
+			if (level + 1 == levels.size())
+				levels.emplace_back();
+			levels[level + 1].push_back(merged);
+		}
+		return SUCCESS;
+	};
+
+	int ret = scanRelation(srcRelId, [&](Attribute *record, recId) {
+		records.insert(records.end(), record, record + info.numAttrs);
+		if (records.size() / info.numAttrs < recordsPerRun)
+			return SUCCESS;
+		return flushRun();
+	});
+
+	if (ret == SUCCESS && levels.empty()) {
+		// everything fit in memory
+		return writeSortedRun(info, records, targetRel);
+	}
+	if (ret == SUCCESS && !records.empty())
+		ret = flushRun();
+	if (ret != SUCCESS) {
+		deleteAllRuns();
+		return ret;
+	}
+
+	// older records are in higher levels, merging in that order keeps the sort stable
+	std::vector<std::string> runs;
+	for (int level = levels.size() - 1; level >= 0; level--)
+		runs.insert(runs.end(), levels[level].begin(), levels[level].end());
+	levels.assign(1, std::vector<std::string>());
+
+	while (runs.size() > SORT_MERGE_FANIN) {
+		std::vector<std::string> oldest(runs.begin(), runs.begin() + SORT_MERGE_FANIN);
+		std::string merged;
+		ret = newRunName(merged);
+		if (ret == SUCCESS)
+			ret = mergeSortedRuns(info, oldest, runName);
+		if (ret != SUCCESS) {
+			levels[0] = runs;
+			deleteAllRuns();
+			return ret;
+		}
+		runs.erase(runs.begin(), runs.begin() + SORT_MERGE_FANIN);
+		runs.insert(runs.begin(), merged);
+	}
+
+	ret = mergeSortedRuns(info, runs, targetRel);
+	if (ret != SUCCESS) {
+		levels[0] = runs;
+		deleteAllRuns();
+	}
+	return ret;
+}
+
+/*
+ * Creates the relation 'targetrel' holding the records of 'srcrel' sorted on 'attr' in the given order (ASC or DESC)
+ */
+int sort(char srcrel[ATTR_SIZE], char targetrel[ATTR_SIZE], char attr[ATTR_SIZE], int order) {
+	int srcRelId = OpenRelTable::getRelationId(srcrel);
+	if (srcRelId == E_RELNOTOPEN)
+		return E_RELNOTOPEN;
+
+	Attribute attrCatEntry[NO_OF_ATTRS_RELCAT_ATTRCAT];
+	int ret = getAttrCatEntry(srcRelId, attr, attrCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+
+	return externalSort(srcRelId, targetrel, static_cast<int>(attrCatEntry[ATTRCAT_OFFSET_INDEX].nval), order);
+}
+
+/*
+ * (join attribute value, record id) pairs of one input of a merge join, in ascending order of the value, read
+ * one leaf at a time from the leaf chain of the B+ tree on the join attribute. The records of the entries of a
+ * leaf are read along with it, record i of the leaf at records[i * numAttrs].
+ * error is set if a leaf or its records cannot be read.
+ */
+typedef struct SortedJoinKeys {
+	std::vector<Index> entries;
+	std::vector<Attribute> records;
+	int numAttrs;
+	int position;
+	int nextLeaf;
+	int error;
+} SortedJoinKeys;
+
+static bool isNaN(Attribute value, int attrType) {
+	return attrType == NUMBER && value.nval != value.nval;
+}
+
+/*
+ * Moves to the next entry, reading the next leaf of the chain and its records when the current one is used up.
+ * Entries with a NaN value, which joins with nothing, are skipped.
+ * Returns false when there are no entries left.
+ */
+static bool nextJoinKey(SortedJoinKeys &keys, int attrType) {
+	keys.position++;
+	while (true) {
+		while (keys.position < (int) keys.entries.size()) {
+			if (!isNaN(keys.entries[keys.position].attrVal, attrType))
+				return true;
+			keys.position++;
+		}
+		if (keys.nextLeaf == -1)
+			return false;
+
+		keys.entries.resize((BLOCK_SIZE - HEADER_SIZE) / LEAF_ENTRY_SIZE);
+		int numEntries = getLeafEntries(keys.entries.data(), keys.nextLeaf);
+		if (numEntries >= 0) {
+			keys.entries.resize(numEntries);
+			keys.records.resize(numEntries * keys.numAttrs);
+			keys.error = getIndexedRecords(keys.records.data(), keys.numAttrs, keys.entries.data(), numEntries);
+		} else {
+			keys.error = numEntries;
+		}
+		if (keys.error != SUCCESS) {
+			keys.entries.clear();
+			return false;
+		}
+		keys.nextLeaf = getHeader(keys.nextLeaf).rblock;
+		keys.position = 0;
+	}
+}
+
+/*
+ * Positions keys before the first entry of the B+ tree rooted at rootBlock
+ */
+static void openJoinKeys(SortedJoinKeys &keys, JoinInput input, int rootBlock) {
+	keys.entries.clear();
+	keys.records.clear();
+	keys.numAttrs = input.numAttrs;
+	keys.error = SUCCESS;
+	// nextJoinKey moves to position 0 of the first leaf after reading it
+	keys.position = -1;
+
+	int block = rootBlock;
+	while (getBlockType(block) == IND_INTERNAL)
+		block = getInternalEntry(block, 0).lChild;
+	keys.nextLeaf = block;
+}
+
+/*
+ * Sort-merge join of two inputs that both have a B+ tree on the join attribute, rooted at rootBlock1 and
+ * rootBlock2: walks both leaf chains in ascending order of the join attribute and joins each group of equal
+ * values of the first input with the group of equal values of the second.
+ */
+int mergeJoin(JoinInput input1, int rootBlock1, JoinInput input2, int rootBlock2, int attrType, int targetRelId) {
+	SortedJoinKeys keys1, keys2;
+	openJoinKeys(keys1, input1, rootBlock1);
+	openJoinKeys(keys2, input2, rootBlock2);
+	bool valid1 = nextJoinKey(keys1, attrType);
+	bool valid2 = nextJoinKey(keys2, attrType);
+
+	int ret = SUCCESS;
+	std::vector<Attribute> group2;
+	while (valid1 && valid2) {
+		Attribute value = keys1.entries[keys1.position].attrVal;
+		int flag = compareAttributes(value, keys2.entries[keys2.position].attrVal, attrType);
+		if (flag < 0) {
+			valid1 = nextJoinKey(keys1, attrType);
+			continue;
+		}
+		if (flag > 0) {
+			valid2 = nextJoinKey(keys2, attrType);
+			continue;
+		}
+
+		// the group of the second input may span leaves, so its records are copied out before moving past them
+		group2.clear();
+		while (valid2 && compareAttributes(keys2.entries[keys2.position].attrVal, value, attrType) == 0) {
+			Attribute *record2 = &keys2.records[keys2.position * input2.numAttrs];
+			group2.insert(group2.end(), record2, record2 + input2.numAttrs);
+			valid2 = nextJoinKey(keys2, attrType);
+		}
+
+		while (valid1 && compareAttributes(keys1.entries[keys1.position].attrVal, value, attrType) == 0) {
+			Attribute *record1 = &keys1.records[keys1.position * input1.numAttrs];
+			for (size_t iter = 0; iter < group2.size() && ret == SUCCESS; iter += input2.numAttrs)
+				ret = insertJoinedRecord(targetRelId, input1, record1, input2, &group2[iter]);
+			if (ret != SUCCESS)
+				valid1 = valid2 = false;
+			else
+				valid1 = nextJoinKey(keys1, attrType);
+		}
+	}
+	if (ret == SUCCESS)
+		ret = (keys1.error != SUCCESS) ? keys1.error : keys2.error;
+	return ret;
+}
+
+/*
+ * Parses data as a NUMBER value, which may be surrounded by whitespace
+ * @return : true if all of data is a number, its value is stored in value
+ */
+static bool parseNumberValue(const char *data, double *value) {
+	char *numberEnd;
+	*value = strtod(data, &numberEnd);
+	if (numberEnd == data)
+		return false;
+	while (isspace((unsigned char) *numberEnd))
+		numberEnd++;
+	return *numberEnd == '\0';
+}
+
+int checkAttrTypeOfValue(char *data) {
+	double ignore;
+	if (parseNumberValue(data, &ignore)) {
 		return NUMBER;
 	} else {
 		return STRING;
@@ -549,6 +1680,32 @@ void getAttrTypesForRelation(int relId, int numAttrs, int attrTypes[]) {
 }
 
 
+/*
+ * Converts the value of an attribute, given as a string, to the type of the attribute, checking that it is valid
+ * @return :
+ *      SUCCESS
+ *      E_ATTRTYPEMISMATCH : a NUMBER attribute is not given a number
+ *      E_INVALID : a STRING attribute is given a character that is not allowed
+ */
+int convertAttrValue(char *data, int attrType, Attribute *value) {
+	if (attrType == NUMBER) {
+		if (!parseNumberValue(data, &value->nval))
+			return E_ATTRTYPEMISMATCH;
+		return SUCCESS;
+	}
+
+	for (int charIndex = 0; charIndex < ATTR_SIZE; ++charIndex) {
+		char ch = data[charIndex];
+		if (ch == '\0')
+			break;
+		if (checkIfInvalidCharacter(ch)) {
+			return E_INVALID;
+		}
+	}
+	strcpy(value->sval, data);
+	return SUCCESS;
+}
+
 /* Construct a record ( array of type Attribute ) from char array of attributes
  * Also performs type checking
  * @param numAttrs : #attributes in the relation
@@ -561,25 +1718,10 @@ void getAttrTypesForRelation(int relId, int numAttrs, int attrTypes[]) {
  */
 int constructRecordFromAttrsArray(int numAttrs, Attribute record[], char recordArray[][ATTR_SIZE], int attrTypes[]) {
 	for (int attributeOffset = 0; attributeOffset < numAttrs; attributeOffset++) {
-
-		if (attrTypes[attributeOffset] == NUMBER) {
-			if (checkAttrTypeOfValue(recordArray[attributeOffset]) == NUMBER)
-				record[attributeOffset].nval = atof(recordArray[attributeOffset]);
-			else
-				return E_ATTRTYPEMISMATCH;
-		}
-
-		if (attrTypes[attributeOffset] == STRING) {
-			for (int charIndex = 0; charIndex < ATTR_SIZE; ++charIndex) {
-				char ch = recordArray[attributeOffset][charIndex];
-				if (ch == '\0')
-					break;
-				if (checkIfInvalidCharacter(ch)) {
-					return E_INVALID;
-				}
-			}
-			strcpy(record[attributeOffset].sval, recordArray[attributeOffset]);
-		}
+		int retValue = convertAttrValue(recordArray[attributeOffset], attrTypes[attributeOffset],
+		                                &record[attributeOffset]);
+		if (retValue != SUCCESS)
+			return retValue;
 	}
 	return SUCCESS;
 }
\ No newline at end of file
@@ -5,10 +5,19 @@
 
 int project(char srcrel[ATTR_SIZE], char targetrel[ATTR_SIZE], int tar_nAttrs, char tar_attrs[][ATTR_SIZE]);
 int select(char srcrel[ATTR_SIZE], char targetrel[ATTR_SIZE], char attr[ATTR_SIZE], int op, char val_str[ATTR_SIZE]);
+int select(char srcrel[ATTR_SIZE], char targetrel[ATTR_SIZE], int numConditions, char attrs[][ATTR_SIZE], int ops[],
+           char val_strs[][ATTR_SIZE]);
+int updateRecords(char relName[ATTR_SIZE], int numAssignments, char setAttrs[][ATTR_SIZE],
+                  char set_val_strs[][ATTR_SIZE], int numConditions, char attrs[][ATTR_SIZE], int ops[],
+                  char val_strs[][ATTR_SIZE]);
+int deleteRecords(char relName[ATTR_SIZE], int numConditions, char attrs[][ATTR_SIZE], int ops[],
+                  char val_strs[][ATTR_SIZE], int *numDeleted);
 int insert(std::vector<std::string> attributeTokens, char *table_name);
 int insert(char relName[ATTR_SIZE], char *fileName);
 int checkAttrTypeOfValue(char *data);
 int constructRecordFromAttrsArray(int numAttrs, Attribute record[], char recordArray[][ATTR_SIZE], int attrTypes[]);
 int join(char srcrel1[ATTR_SIZE], char srcrel2[ATTR_SIZE], char targetRelation[ATTR_SIZE], char attr1[ATTR_SIZE], char attr2[ATTR_SIZE]);
+int sort(char srcrel[ATTR_SIZE], char targetrel[ATTR_SIZE], char attr[ATTR_SIZE], int order);
+int externalSort(int srcRelId, char targetRel[ATTR_SIZE], int keyOffset, int order);
 
 #endif //NITCBASE_ALGEBRA_H
\ No newline at end of file
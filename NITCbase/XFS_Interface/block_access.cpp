@@ -2,16 +2,24 @@
 #include <string>
 #include <cstring>
 #include <iostream>
+#include <vector>
+#include <algorithm>
 #include "define/constants.h"
 #include "define/errors.h"
 #include "disk_structures.h"
 #include "schema.h"
 #include "OpenRelTable.h"
 #include "BPlusTree.h"
+#include "block_allocation.h"
+#include "composite_index.h"
+#include "Disk.h"
 
-int getFreeRecBlock();
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define FILTER_X86
+#endif
 
-recId getFreeSlot(int block_num);
+recId getFreeSlot(int relId, Attribute relCatEntry[6]);
 
 int deleteRelCatEntry(recId relcat_recid, Attribute relcat_rec[6]);
 
@@ -25,36 +33,11 @@ int ba_insert(int relId, Attribute *rec) {
 	getRelCatEntry(relId, relCatEntry);
 
 	int num_attrs = (int)relCatEntry[RELCAT_NO_ATTRIBUTES_INDEX].nval;
-	int first_block = (int)relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval;
-	int num_slots = (int)relCatEntry[RELCAT_NO_SLOTS_PER_BLOCK_INDEX].nval;
 
 	HeadInfo header;
 
-	unsigned char slotmap[num_slots];
-	int blockNum = first_block;
-
-	if (first_block == -1) {
-		blockNum = getFreeRecBlock();
-		relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval = blockNum;
-
-		// TODO: Take make_headerInfo() function out
-		HeadInfo *headInfo = (HeadInfo *) malloc(sizeof(HeadInfo));
-		headInfo->blockType = REC;
-		headInfo->pblock = -1;
-		headInfo->lblock = -1;
-		headInfo->rblock = -1;
-		headInfo->numEntries = 0;
-		headInfo->numAttrs = num_attrs;
-		headInfo->numSlots = num_slots;
-		setHeader(headInfo, blockNum);
-		getSlotmap(slotmap, blockNum);
-
-		// set all slots as free
-		memset(slotmap, SLOT_UNOCCUPIED, sizeof(slotmap));
-		setSlotmap(slotmap, num_slots, blockNum);
-	}
-
-	recId rec_id = getFreeSlot(blockNum);
+	// getFreeSlot() updates the first and last block in the relation catalog entry if it adds a block
+	recId rec_id = getFreeSlot(relId, relCatEntry);
 
 	// no free slot found
 	if (rec_id.block == -1 && rec_id.slot == -1) {
@@ -70,11 +53,11 @@ int ba_insert(int relId, Attribute *rec) {
 	header = getHeader(rec_id.block);
 	header.numEntries = header.numEntries + 1;
 	setHeader(&header, rec_id.block);
+	if (header.numEntries == header.numSlots)
+		OpenRelTable::setFreeSpace(relId, rec_id.block, false);
 
 	// increment #entries in relation catalog entry
 	relCatEntry[RELCAT_NO_RECORDS_INDEX].nval = relCatEntry[RELCAT_NO_RECORDS_INDEX].nval + 1;
-	// update last block in relation catalogue entry
-	relCatEntry[RELCAT_LAST_BLOCK_INDEX].nval = rec_id.block;
 	setRelCatEntry(relId, relCatEntry);
 
 	char attrName[ATTR_SIZE];
@@ -94,10 +77,326 @@ int ba_insert(int relId, Attribute *rec) {
 			bPlusTree.bPlusInsert(rec[i], rec_id);
 		}
 	}
+	// insert the record into the composite indexes of the relation as well
+	insertIntoCompositeIndexes(relId, rec, rec_id);
+
+	return SUCCESS;
+}
+
+/*
+ *  Starts a bulk insert into the Relation, noting the indexes whose entries it will collect
+ */
+int ba_beginBulkInsert(int relId, BulkInsert *bulk) {
+	Attribute relCatEntry[6];
+	int ret = getRelCatEntry(relId, relCatEntry);
+	if (ret != SUCCESS)
+		return ret;
+	int num_attrs = (int)relCatEntry[RELCAT_NO_ATTRIBUTES_INDEX].nval;
+
+	bulk->relId = relId;
+	bulk->numExisting = (int)relCatEntry[RELCAT_NO_RECORDS_INDEX].nval;
+	bulk->attrOffsets.clear();
+	for (int i = 0; i < num_attrs; i++) {
+		Attribute attrCatEntry[6];
+		getAttrCatEntry(relId, i, attrCatEntry);
+		if ((int) attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval != -1)
+			bulk->attrOffsets.push_back(i);
+	}
+	bulk->attrEntries.assign(bulk->attrOffsets.size(), std::vector<Index>());
 
+	bulk->compositeIndexes.clear();
+	ret = getCompositeIndexes(relId, bulk->compositeIndexes);
+	if (ret != SUCCESS)
+		return ret;
+	bulk->compositeEntries.assign(bulk->compositeIndexes.size(), std::vector<Index>());
 	return SUCCESS;
 }
 
+/*
+ *  Writes a batch of records of the bulk insert into the Relation, a block at a time
+ *      - First into the free slots of the blocks its free space map marks as not full
+ *      - Then into new blocks, allotted as one extent if the disk has one and linked after the last block
+ *  #Records and LastBlock in the relation catalog are updated once for the batch. The index entries of the
+ *  records are only collected, for ba_endBulkInsert.
+ *  Returns E_DISKFULL, with the records that fit inserted, if the disk is full
+ */
+int ba_bulkInsert(BulkInsert *bulk, Attribute *records, int numRecords) {
+	int relId = bulk->relId;
+	Attribute relCatEntry[6];
+	getRelCatEntry(relId, relCatEntry);
+	int num_attrs = (int)relCatEntry[RELCAT_NO_ATTRIBUTES_INDEX].nval;
+	int num_slots = (int)relCatEntry[RELCAT_NO_SLOTS_PER_BLOCK_INDEX].nval;
+	int record_size = num_attrs * ATTR_SIZE;
+
+	unsigned char buffer[BLOCK_SIZE];
+	unsigned char *slotmap = buffer + HEADER_SIZE;
+	unsigned char *block_records = buffer + HEADER_SIZE + num_slots;
+	HeadInfo header;
+
+	std::vector<recId> rec_ids;
+	rec_ids.reserve(numRecords);
+
+	// fill the free slots of the blocks with room, one read and one write per block
+	int block_num;
+	while ((int) rec_ids.size() < numRecords && (block_num = OpenRelTable::getFreeSpaceBlock(relId)) >= 0) {
+		Disk::readBlock(buffer, block_num);
+		memcpy(&header, buffer, HEADER_SIZE);
+		for (int slot = 0; slot < num_slots && (int) rec_ids.size() < numRecords; slot++) {
+			if (slotmap[slot] == SLOT_UNOCCUPIED) {
+				slotmap[slot] = SLOT_OCCUPIED;
+				memcpy(block_records + slot * record_size, records + rec_ids.size() * num_attrs, record_size);
+				rec_ids.push_back({block_num, slot});
+				header.numEntries++;
+			}
+		}
+		memcpy(buffer, &header, HEADER_SIZE);
+		Disk::writeBlock(buffer, block_num);
+		if (memchr(slotmap, SLOT_UNOCCUPIED, num_slots) == nullptr)
+			OpenRelTable::setFreeSpace(relId, block_num, false);
+	}
+
+	// allot the blocks for the rest, as one extent if possible
+	int num_left = numRecords - (int) rec_ids.size();
+	int num_blocks = (num_left + num_slots - 1) / num_slots;
+	std::vector<int> blocks;
+	int first_block = num_blocks > 0 ? getFreeBlocks(REC, num_blocks) : -1;
+	if (first_block >= 0) {
+		for (int iter = 0; iter < num_blocks; iter++)
+			blocks.push_back(first_block + iter);
+	} else {
+		for (int iter = 0; iter < num_blocks; iter++) {
+			block_num = getFreeRecBlock();
+			if (block_num == -1)
+				break;
+			blocks.push_back(block_num);
+		}
+	}
+
+	// write each new block whole, with its records in its first slots
+	int last_block = (int)relCatEntry[RELCAT_LAST_BLOCK_INDEX].nval;
+	int num_new_blocks = blocks.size();
+	for (int iter = 0; iter < num_new_blocks; iter++) {
+		int count = std::min(num_slots, numRecords - (int) rec_ids.size());
+		memset(buffer, 0, BLOCK_SIZE);
+		memset(&header, 0, sizeof(header));
+		header.blockType = REC;
+		header.pblock = -1;
+		header.lblock = (iter > 0) ? blocks[iter - 1] : last_block;
+		header.rblock = (iter + 1 < num_new_blocks) ? blocks[iter + 1] : -1;
+		header.numEntries = count;
+		header.numAttrs = num_attrs;
+		header.numSlots = num_slots;
+		memcpy(buffer, &header, HEADER_SIZE);
+		memset(slotmap, SLOT_UNOCCUPIED, num_slots);
+		memset(slotmap, SLOT_OCCUPIED, count);
+		memcpy(block_records, records + rec_ids.size() * num_attrs, count * record_size);
+		Disk::writeBlock(buffer, blocks[iter]);
+
+		for (int slot = 0; slot < count; slot++)
+			rec_ids.push_back({blocks[iter], slot});
+		if (count < num_slots)
+			OpenRelTable::setFreeSpace(relId, blocks[iter], true);
+	}
+
+	// link the new blocks after the last block of the relation
+	if (num_new_blocks > 0) {
+		if (last_block != -1) {
+			header = getHeader(last_block);
+			header.rblock = blocks[0];
+			setHeader(&header, last_block);
+		} else {
+			relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval = blocks[0];
+		}
+		relCatEntry[RELCAT_LAST_BLOCK_INDEX].nval = blocks.back();
+	}
+
+	int num_inserted = rec_ids.size();
+	relCatEntry[RELCAT_NO_RECORDS_INDEX].nval = relCatEntry[RELCAT_NO_RECORDS_INDEX].nval + num_inserted;
+	setRelCatEntry(relId, relCatEntry);
+
+	// collect the index entries of the records
+	Index entry;
+	memset(&entry, 0, sizeof(entry));
+	for (size_t index = 0; index < bulk->attrOffsets.size(); index++) {
+		for (int iter = 0; iter < num_inserted; iter++) {
+			entry.attrVal = records[iter * num_attrs + bulk->attrOffsets[index]];
+			entry.block = rec_ids[iter].block;
+			entry.slot = rec_ids[iter].slot;
+			bulk->attrEntries[index].push_back(entry);
+		}
+	}
+	Attribute values[COMPOSITE_INDEX_MAX_ATTRS];
+	for (size_t index = 0; index < bulk->compositeIndexes.size(); index++) {
+		CompositeIndex &compositeIndex = bulk->compositeIndexes[index];
+		for (int iter = 0; iter < num_inserted; iter++) {
+			for (int attr = 0; attr < compositeIndex.numAttrs; attr++)
+				values[attr] = records[iter * num_attrs + compositeIndex.attrOffsets[attr]];
+			encodeCompositeKey(values, compositeIndex.attrTypes, compositeIndex.numAttrs, 0, &entry.attrVal);
+			entry.block = rec_ids[iter].block;
+			entry.slot = rec_ids[iter].slot;
+			bulk->compositeEntries[index].push_back(entry);
+		}
+	}
+
+	return (num_inserted == numRecords) ? SUCCESS : E_DISKFULL;
+}
+
+/*
+ *  Finishes a bulk insert by adding the index entries it collected to the indexes of the Relation
+ */
+int ba_endBulkInsert(BulkInsert *bulk) {
+	int retVal = SUCCESS;
+	for (size_t index = 0; index < bulk->attrOffsets.size(); index++) {
+		Attribute attrCatEntry[6];
+		getAttrCatEntry(bulk->relId, bulk->attrOffsets[index], attrCatEntry);
+		BPlusTree bPlusTree = BPlusTree(bulk->relId, attrCatEntry[ATTRCAT_ATTR_NAME_INDEX].sval);
+		std::vector<Index> &entries = bulk->attrEntries[index];
+		int ret = bPlusTree.bPlusInsertBatch(entries.data(), entries.size(), bulk->numExisting);
+		if (ret != SUCCESS)
+			retVal = ret;
+		std::vector<Index>().swap(entries);
+	}
+	for (size_t index = 0; index < bulk->compositeIndexes.size(); index++) {
+		std::vector<Index> &entries = bulk->compositeEntries[index];
+		int ret = insertEntriesIntoCompositeIndex(bulk->compositeIndexes[index], entries.data(), entries.size(),
+		                                          bulk->numExisting);
+		if (ret != SUCCESS)
+			retVal = ret;
+		std::vector<Index>().swap(entries);
+	}
+	return retVal;
+}
+
+/*
+ *  Deletes the record in the given slot of the Relation
+ *      - Removes its entries from the B+ trees and composite indexes of the relation
+ *      - Marks the slot free in the slot map of its record block
+ *      - Releases the record block, unlinking it from the blocks of the relation, if it is left empty
+ *  If an entry of the record cannot be removed from an index, the error is returned and the slot is kept
+ */
+int ba_deleteRecord(int relId, recId recid) {
+	Attribute relCatEntry[6];
+	getRelCatEntry(relId, relCatEntry);
+	int num_attrs = (int)relCatEntry[RELCAT_NO_ATTRIBUTES_INDEX].nval;
+
+	HeadInfo header = getHeader(recid.block);
+	if (header.blockType != REC || recid.slot < 0 || recid.slot >= header.numSlots)
+		return E_OUTOFBOUND;
+	unsigned char slotmap[header.numSlots];
+	getSlotmap(slotmap, recid.block);
+	if (slotmap[recid.slot] == SLOT_UNOCCUPIED)
+		return E_FREESLOT;
+
+	Attribute rec[num_attrs];
+	getRecord(rec, recid.block, recid.slot);
+
+	/*
+	 * B+ TREE MODIFICATIONS
+	 */
+	for (int i = 0; i < num_attrs; i++) {
+		Attribute attrCatEntry[6];
+		getAttrCatEntry(relId, i, attrCatEntry);
+
+		// if index exists for the attribute, delete the entry of the record from the b plus tree
+		if ((int) attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval != -1) {
+			BPlusTree bPlusTree = BPlusTree(relId, attrCatEntry[ATTRCAT_ATTR_NAME_INDEX].sval);
+			int ret = bPlusTree.bPlusDelete(rec[i], recid);
+			if (ret != SUCCESS)
+				return ret;
+		}
+	}
+	int ret = deleteFromCompositeIndexes(relId, rec, recid);
+	if (ret != SUCCESS)
+		return ret;
+
+	// free the slot, and decrement #entries in header
+	slotmap[recid.slot] = SLOT_UNOCCUPIED;
+	setSlotmap(slotmap, header.numSlots, recid.block);
+	header.numEntries = header.numEntries - 1;
+	setHeader(&header, recid.block);
+
+	// release the block once its last record is gone (standard linked list delete for a block)
+	if (header.numEntries == 0) {
+		if (header.lblock != -1) {
+			HeadInfo prev_header = getHeader(header.lblock);
+			prev_header.rblock = header.rblock;
+			setHeader(&prev_header, header.lblock);
+		} else {
+			relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval = header.rblock;
+		}
+		if (header.rblock != -1) {
+			HeadInfo next_header = getHeader(header.rblock);
+			next_header.lblock = header.lblock;
+			setHeader(&next_header, header.rblock);
+		} else {
+			relCatEntry[RELCAT_LAST_BLOCK_INDEX].nval = header.lblock;
+		}
+		OpenRelTable::setFreeSpace(relId, recid.block, false);
+		deleteBlock(recid.block);
+	} else {
+		OpenRelTable::setFreeSpace(relId, recid.block, true);
+	}
+
+	// decrement #entries in relation catalog entry
+	relCatEntry[RELCAT_NO_RECORDS_INDEX].nval = relCatEntry[RELCAT_NO_RECORDS_INDEX].nval - 1;
+	setRelCatEntry(relId, relCatEntry);
+
+	return SUCCESS;
+}
+
+/*
+ *  Overwrites the record in the given slot of the Relation with newRec, in place
+ *      - Moves the entries of the record in the B+ trees on the attributes whose values change
+ *      - Replaces the keys of the record in the composite indexes whose keys change
+ *  Returns the first error met in updating the indexes, after updating all of them
+ */
+int ba_updateRecord(int relId, recId recid, Attribute *newRec) {
+	Attribute relCatEntry[6];
+	getRelCatEntry(relId, relCatEntry);
+	int num_attrs = (int)relCatEntry[RELCAT_NO_ATTRIBUTES_INDEX].nval;
+
+	HeadInfo header = getHeader(recid.block);
+	if (header.blockType != REC || recid.slot < 0 || recid.slot >= header.numSlots)
+		return E_OUTOFBOUND;
+	unsigned char slotmap[header.numSlots];
+	getSlotmap(slotmap, recid.block);
+	if (slotmap[recid.slot] == SLOT_UNOCCUPIED)
+		return E_FREESLOT;
+
+	Attribute oldRec[num_attrs];
+	getRecord(oldRec, recid.block, recid.slot);
+	setRecord(newRec, recid.block, recid.slot);
+
+	/*
+	 * B+ TREE MODIFICATIONS
+	 */
+	int retVal = SUCCESS;
+	for (int i = 0; i < num_attrs; i++) {
+		Attribute attrCatEntry[6];
+		getAttrCatEntry(relId, i, attrCatEntry);
+		if ((int) attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval == -1)
+			continue;
+
+		// the bytes of a value are compared, as compareAttributes never finds a NaN equal to anything, not even itself
+		int attrType = (int) attrCatEntry[ATTRCAT_ATTR_TYPE_INDEX].nval;
+		if (attrType == NUMBER ? memcmp(&oldRec[i].nval, &newRec[i].nval, sizeof(double)) == 0
+		                       : strcmp(oldRec[i].sval, newRec[i].sval) == 0)
+			continue;
+
+		// if index exists for the changed attribute, move the entry of the record in the b plus tree
+		// the new value is inserted even if the old one is missing, so that the record can still be found
+		BPlusTree bPlusTree = BPlusTree(relId, attrCatEntry[ATTRCAT_ATTR_NAME_INDEX].sval);
+		int ret = bPlusTree.bPlusDelete(oldRec[i], recid);
+		int insertRet = bPlusTree.bPlusInsert(newRec[i], recid);
+		if (ret == SUCCESS)
+			ret = insertRet;
+		if (ret != SUCCESS)
+			retVal = ret;
+	}
+	int ret = updateCompositeIndexes(relId, oldRec, newRec, recid);
+	return (retVal != SUCCESS) ? retVal : ret;
+}
+
 /*
  *  Searches the relation specified to find the 'next' record starting from the given 'prev' record
  *  that satisfies the op condition on given attrval
@@ -143,8 +442,6 @@ recId linear_search(relId relid, char attrName[ATTR_SIZE], union Attribute attrv
 	int offset, attr_type;
 	//get the record itself in relcat_entry array of attributes
 	int curr_block, curr_slot, next_block = -1;
-	int no_of_attributes = relcat_entry[1].nval;
-	int no_of_slots = relcat_entry[5].nval;
 
 	if (op != PRJCT) {
 		union Attribute attrcat_entry[6];
@@ -164,54 +461,33 @@ recId linear_search(relId relid, char attrName[ATTR_SIZE], union Attribute attrv
 		curr_slot = prev_recid->slot + 1;
 	}
 
-	unsigned char slotmap[no_of_slots];
+	RecordBatch batch;
+	uint64_t selected[((BLOCK_SIZE - HEADER_SIZE) / ATTR_SIZE + 63) / 64];
 	/*
 	 * Iterate through all blocks starting from curr_block
 	 */
 	while (curr_block != -1) {
-		struct HeadInfo header;
-		header = getHeader(curr_block);
-		next_block = header.rblock;
-		getSlotmap(slotmap, curr_block);
+		if (getRecordBatch(&batch, curr_block) != SUCCESS)
+			break;
+		next_block = batch.header.rblock;
+		/*
+		 * Evaluate the condition over the whole block at once
+		 */
+		if (op != PRJCT && attr_type == NUMBER)
+			filterNumbers(batch.records + offset, batch.numRecords, batch.header.numAttrs, attrval.nval, op, selected);
+		else if (op != PRJCT)
+			filterStrings(batch.records + offset, batch.numRecords, batch.header.numAttrs, attrval.sval, op, selected);
 		/*
-		 * Iterate through all the Slots(Records) in the curr_block
+		 * Iterate through all the occupied Slots(Records) in the curr_block, skipping those before curr_slot
 		 */
-		for (int slotNum = curr_slot; slotNum < no_of_slots; slotNum++) {
-			union Attribute record[no_of_attributes];
-			if (slotmap[slotNum] == SLOT_UNOCCUPIED) {
+		for (int iter = 0; iter < batch.numRecords; iter++) {
+			int slotNum = batch.slotNums[iter];
+			if (slotNum < curr_slot) {
 				continue;
 			}
-			// Get the record corresponding to {curr_block, slotNum=slotNum}
-			getRecord(record, curr_block, slotNum);
 			bool cond = false;
-			if (op != PRJCT) {
-				int flag = compareAttributes(record[offset], attrval, attr_type);
-				switch (op) {
-					case NE:
-						if (flag != 0)
-							cond = true;
-						break;
-					case LT:
-						if (flag < 0)
-							cond = true;
-						break;
-					case LE:
-						if (flag <= 0)
-							cond = true;
-						break;
-					case EQ:
-						if (flag == 0)
-							cond = true;
-						break;
-					case GT:
-						if (flag > 0)
-							cond = true;
-						break;
-					case GE:
-						if (flag >= 0)
-							cond = true;
-				}
-			}
+			if (op != PRJCT)
+				cond = (selected[iter / 64] >> (iter % 64)) & 1;
 			if (cond == true || op == PRJCT) {
 				ret_recid = {curr_block, slotNum};
 				/*
@@ -368,6 +644,9 @@ int ba_delete(char relName[ATTR_SIZE]) {
 		prev_recid.slot = -1;
 	}
 
+	// Delete the composite indexes on the relation and their Index Catalog entries
+	deleteCompositeIndexes(relName);
+
 	/*
 	 * Delete Relation Catalog Entry
 	 */
@@ -419,6 +698,9 @@ int ba_renamerel(char oldName[ATTR_SIZE], char newName[ATTR_SIZE]) {
 			break;
 	}
 
+	// UPDATE THE INDEX CATALOG ENTRIES OF THE RELATION WITH NEW NAME
+	renameCompositeIndexRelation(oldName, newName);
+
 	return SUCCESS;
 }
 
@@ -463,6 +745,7 @@ int ba_renameattr(char relName[ATTR_SIZE], char oldName[ATTR_SIZE], char newName
 			if (std::strcmp(attrcat_record[1].sval, oldName) == 0) {
 				strcpy(attrcat_record[1].sval, newName);
 				setRecord(attrcat_record, attrcat_recid.block, attrcat_recid.slot);
+				renameCompositeIndexAttribute(relName, oldName, newName);
 				return SUCCESS;
 			}
 		} else
@@ -470,20 +753,6 @@ int ba_renameattr(char relName[ATTR_SIZE], char oldName[ATTR_SIZE], char newName
 	}
 }
 
-/*
- * Retrieves whether the block is occupied or not
- * If occupied returns the type of occupied block (REC: 0, IND_INTERNAL: 1, IND_LEAF: 2)
- * If Not returns UNUSED_BLK: 3
- */
-int getBlockType(int blocknum) {
-	FILE *disk = fopen(&DISK_PATH[0], "rb");
-	fseek(disk, 0, SEEK_SET);
-	unsigned char blockAllocationMap[4 * BLOCK_SIZE];
-	fread(blockAllocationMap, 4 * BLOCK_SIZE, 1, disk);
-	fclose(disk);
-	return (int32_t) (blockAllocationMap[blocknum]);
-}
-
 /*
  * Reads header for 'blockNum'th block from disk
  */
@@ -529,92 +798,28 @@ void setSlotmap(unsigned char *SlotMap, int no_of_slots, int blockNum) {
 	fclose(disk);
 }
 
-int getFreeBlock(int block_type) {
-
-	FILE *disk = fopen(&DISK_PATH[0], "rb+");
-	fseek(disk, 0, SEEK_SET);
-	unsigned char blockAllocationMap[4 * BLOCK_SIZE];
-	fread(blockAllocationMap, 4 * BLOCK_SIZE, 1, disk);
-	for (int iter = 0; iter < 4 * BLOCK_SIZE; iter++) {
-		if ((int32_t) (blockAllocationMap[iter]) == UNUSED_BLK) {
-			blockAllocationMap[iter] = (unsigned char) block_type;
-			fseek(disk, 0, SEEK_SET);
-			fwrite(blockAllocationMap, BLOCK_SIZE * 4, 1, disk);
-			fclose(disk);
-			return iter;
-		}
-	}
-
-	return FAILURE;
-}
-
-/*
- *
+/* Finds a free slot of the relation either from :
+ *      - a block of the relation with a free slot, as found in its free space map or
+ *      - a newly allotted block, linked after the last block of the relation
+ * The first and last block in relCatEntry are updated when a block is added; the caller writes it back.
  */
-int getFreeRecBlock() {
-	// TODO: Title for this
-	FILE *disk = fopen(&DISK_PATH[0], "rb+");
-	fseek(disk, 0, SEEK_SET);
-
-	unsigned char blockAllocationMap[4 * BLOCK_SIZE];
-	fread(blockAllocationMap, 4 * BLOCK_SIZE, 1, disk);
-
-	for (int iter = 0; iter < 4 * BLOCK_SIZE; iter++) {
-		if ((int32_t) (blockAllocationMap[iter]) == UNUSED_BLK) {
-			blockAllocationMap[iter] = (unsigned char) REC;
-			fseek(disk, 0, SEEK_SET);
-			fwrite(blockAllocationMap, BLOCK_SIZE * 4, 1, disk);
-			fclose(disk);
-			return iter;
-		}
-	}
-
-	return FAILURE;
-}
+recId getFreeSlot(int relId, Attribute relCatEntry[6]) {
+	int num_attrs = (int)relCatEntry[RELCAT_NO_ATTRIBUTES_INDEX].nval;
+	int num_slots = (int)relCatEntry[RELCAT_NO_SLOTS_PER_BLOCK_INDEX].nval;
+	unsigned char slotmap[num_slots];
 
-/* Finds a free slot either from :
- *      - the block numbered 'block_num' or
- *      - next blocks in the linked list of blocks for the relation or
- *      - a newly allotted block for the relation
- */
-// TODO: is the relation checked for being relcat or attrcat and if so, is it being allocated a second block
-recId getFreeSlot(int block_num) {
-	recId recid = {-1, -1};
-	int prev_block_num, next_block_num;
-	int num_slots;
-	int num_attrs;
-	struct HeadInfo header;
-
-	// finding free slot
-	while (block_num != -1) {
-		header = getHeader(block_num);
-		num_slots = header.numSlots;
-		next_block_num = header.rblock;
-		num_attrs = header.numAttrs;
-
-		// getting slotmap for the current block
-		unsigned char slotmap[num_slots];
+	// finding free slot in a block the free space map has marked as not full
+	int block_num;
+	while ((block_num = OpenRelTable::getFreeSpaceBlock(relId)) >= 0) {
 		getSlotmap(slotmap, block_num);
-
-		// searching for free slot in block (block_num)
-		int iter;
-		for (iter = 0; iter < num_slots; iter++) {
-			if (slotmap[iter] == SLOT_UNOCCUPIED) {
-				break;
-			}
-		}
-
-		// if free slot found, return it
-		if (iter < num_slots) {
-			slotmap[iter] = SLOT_OCCUPIED;
+		unsigned char *free_slot = (unsigned char *) memchr(slotmap, SLOT_UNOCCUPIED, num_slots);
+		if (free_slot != nullptr) {
+			*free_slot = SLOT_OCCUPIED;
 			setSlotmap(slotmap, num_slots, block_num);
-			recid = {block_num, iter};
-			return recid;
+			return {block_num, (int) (free_slot - slotmap)};
 		}
-
-		// free slot not found in the current block, check the next block
-		prev_block_num = block_num;
-		block_num = next_block_num;
+		// the block was filled without the map knowing (eg. by a catalog write), skip it from now on
+		OpenRelTable::setFreeSpace(relId, block_num, false);
 	}
 
 	/*
@@ -622,46 +827,47 @@ recId getFreeSlot(int block_num) {
 	 * get new record block
 	 * in case of RELCAT, do not go for next block (only one block allowed)
 	 */
-	if (prev_block_num == RELCAT_BLOCK) {
+	int last_block = (int)relCatEntry[RELCAT_LAST_BLOCK_INDEX].nval;
+	if (relId == RELCAT_RELID && last_block != -1) {
 		return {E_MAXRELATIONS, E_MAXRELATIONS};
-	} else {
-		block_num = getFreeRecBlock();
 	}
+	block_num = getFreeRecBlock();
 
 	// no free blocks available in disk
 	if (block_num == -1) {
 		// no free slot can be found, return {-1, -1}
-		return recid;
+		return {-1, -1};
 	}
 
-	// TODO: make_headerInfo() function extract
-	// TODO: make_slotMap() which returns an empty slotMap extract
-	// TODO: getFreeRecBlock() function may be expanded to also set the header information
-	//          OR make a function that gets a free block and sets both its header and slotMap
 	//setting header for new record block
-	header = getHeader(block_num);
-	header.numSlots = num_slots;
-	header.lblock = prev_block_num;
+	HeadInfo header = getHeader(block_num);
+	header.blockType = REC;
+	header.pblock = -1;
+	header.lblock = last_block;
 	header.rblock = -1;
+	header.numEntries = 0;
 	header.numAttrs = num_attrs;
+	header.numSlots = num_slots;
 	setHeader(&header, block_num);
 
 	//setting slotmap
-	unsigned char slotmap[num_slots];
-	getSlotmap(slotmap, block_num);
 	memset(slotmap, SLOT_UNOCCUPIED, sizeof(slotmap)); //all slots are free
 	slotmap[0] = SLOT_OCCUPIED;
 	setSlotmap(slotmap, num_slots, block_num);
 
-	// recid of free slot
-	recid = {block_num, 0};
-
-	//setting prev_block_num rblock to new block
-	header = getHeader(prev_block_num);
-	header.rblock = block_num;
-	setHeader(&header, prev_block_num);
+	//linking the new block after the last block of the relation
+	if (last_block != -1) {
+		header = getHeader(last_block);
+		header.rblock = block_num;
+		setHeader(&header, last_block);
+	} else {
+		relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval = block_num;
+	}
+	relCatEntry[RELCAT_LAST_BLOCK_INDEX].nval = block_num;
+	OpenRelTable::setFreeSpace(relId, block_num, true);
 
-	return recid;
+	// recid of free slot
+	return {block_num, 0};
 }
 
 /*
@@ -706,6 +912,89 @@ int getRecord(Attribute *rec, int blockNum, int slotNum) {
 }
 
 
+/*
+ * Reads the header, slotmap and every occupied record of the record block 'blockNum' from disk
+ * with a single read, so that a scan pays for one disk access per block instead of one per slot.
+ * The occupied records are packed one after the other in batch->records (see RecordBatch).
+ */
+int getRecordBatch(RecordBatch *batch, int blockNum) {
+	if (blockNum < 0 || blockNum >= DISK_BLOCKS)
+		return E_OUTOFBOUND;
+	if (getBlockType(blockNum) != REC)
+		return FAILURE;
+
+	unsigned char block[BLOCK_SIZE];
+	FILE *disk = fopen(&DISK_PATH[0], "rb");
+	fseek(disk, blockNum * BLOCK_SIZE, SEEK_SET);
+	fread(block, BLOCK_SIZE, 1, disk);
+	fclose(disk);
+
+	memcpy(&batch->header, block, HEADER_SIZE);
+	int numSlots = batch->header.numSlots;
+	int recordSize = batch->header.numAttrs * ATTR_SIZE;
+	if (numSlots < 0 || HEADER_SIZE + numSlots + numSlots * recordSize > BLOCK_SIZE)
+		return FAILURE;
+
+	unsigned char *slotMap = block + HEADER_SIZE;
+	unsigned char *records = slotMap + numSlots;
+	memcpy(batch->slotMap, slotMap, numSlots);
+
+	/* Copy each run of consecutive occupied slots with one memcpy */
+	batch->numRecords = 0;
+	int slotNum = 0;
+	while (slotNum < numSlots) {
+		if (slotMap[slotNum] == SLOT_UNOCCUPIED) {
+			slotNum++;
+			continue;
+		}
+		int runStart = slotNum;
+		while (slotNum < numSlots && slotMap[slotNum] != SLOT_UNOCCUPIED) {
+			batch->slotNums[batch->numRecords + slotNum - runStart] = slotNum;
+			slotNum++;
+		}
+		memcpy((unsigned char *) batch->records + batch->numRecords * recordSize,
+		       records + runStart * recordSize, (slotNum - runStart) * recordSize);
+		batch->numRecords += slotNum - runStart;
+	}
+	return SUCCESS;
+}
+
+/*
+ * Reads the records that the index entries entries[0] to entries[numEntries - 1] point to, the record of entry i
+ * going to records[i * numAttrs]. The entries are visited in order of block and slot, so that each record block
+ * is read once (with getRecordBatch) however many of the entries point into it.
+ */
+int getIndexedRecords(Attribute *records, int numAttrs, const Index *entries, int numEntries) {
+	std::vector<int> order(numEntries);
+	for (int iter = 0; iter < numEntries; iter++)
+		order[iter] = iter;
+	std::sort(order.begin(), order.end(), [&](int entry1, int entry2) {
+		if (entries[entry1].block != entries[entry2].block)
+			return entries[entry1].block < entries[entry2].block;
+		return entries[entry1].slot < entries[entry2].slot;
+	});
+
+	RecordBatch batch;
+	int batchBlock = -1;
+	int position = 0;
+	for (int index : order) {
+		const Index &entry = entries[index];
+		if (entry.block != batchBlock) {
+			int ret = getRecordBatch(&batch, entry.block);
+			if (ret != SUCCESS)
+				return ret;
+			batchBlock = entry.block;
+			position = 0;
+		}
+		while (position < batch.numRecords && batch.slotNums[position] < entry.slot)
+			position++;
+		if (position == batch.numRecords || batch.slotNums[position] != entry.slot)
+			return FAILURE;
+		memcpy(records + index * numAttrs, batch.records + position * numAttrs, numAttrs * sizeof(Attribute));
+	}
+	return SUCCESS;
+}
+
 /*
  * Writes record into disk
  */
@@ -913,11 +1202,11 @@ int deleteBlock(int blockNum) {
 	for (int i = 0; i < BLOCK_SIZE; i++)
 		fputc(0, disk);
 
-	/* Mark this block as UNUSED in the Block Allocation Map */
-	fseek(disk, blockNum, SEEK_SET);
-	fputc((unsigned char) UNUSED_BLK, disk);
 	fclose(disk);
 
+	/* Mark this block as UNUSED in the Block Allocation Map */
+	releaseBlockAllocation(blockNum);
+
 	return SUCCESS;
 }
 
@@ -951,6 +1240,7 @@ int deleteRelCatEntry(recId relcat_recid, Attribute relcat_rec[6]) {
 	getSlotmap(relcat_slotmap, 4);
 	relcat_slotmap[relcat_recid.slot] = SLOT_UNOCCUPIED;
 	setSlotmap(relcat_slotmap, 20, relcat_recid.block);
+	OpenRelTable::setFreeSpace(RELCAT_RELID, relcat_recid.block, true);
 
 	FILE *disk = fopen(&DISK_PATH[0], "rb+");
 	fseek(disk, (relcat_recid.block) * BLOCK_SIZE + HEADER_SIZE + SLOTMAP_SIZE_RELCAT_ATTRCAT +
@@ -1007,12 +1297,43 @@ int deleteAttrCatEntry(recId attrcat_recid) {
 			HeadInfo next_header = getHeader(header.rblock);
 			next_header.lblock = header.lblock;
 			setHeader(&next_header, header.rblock);
+		} else {
+			/* The block was the last block of the Attribute Catalog */
+			Attribute relcat_rec[6];
+			getRecord(relcat_rec, RELCAT_BLOCK, RELCAT_SLOTNUM_FOR_ATTRCAT);
+			relcat_rec[RELCAT_LAST_BLOCK_INDEX].nval = header.lblock;
+			setRecord(relcat_rec, RELCAT_BLOCK, RELCAT_SLOTNUM_FOR_ATTRCAT);
 		}
+		OpenRelTable::setFreeSpace(ATTRCAT_RELID, attrcat_recid.block, false);
 		deleteBlock(attrcat_recid.block);
+	} else {
+		OpenRelTable::setFreeSpace(ATTRCAT_RELID, attrcat_recid.block, true);
 	}
 	return SUCCESS;
 }
 
+/*
+ * strcmp for STRING attributes, which are always ATTR_SIZE (16) bytes wide and so fit in one SSE register.
+ * Both values are compared in a single step: the result is decided by the first byte that either differs
+ * or is the terminating NUL of str1, and bytes after it are never looked at. A value that fills all
+ * 16 bytes without a NUL compares like a 16 character string.
+ */
+static int compareStrings(const char *str1, const char *str2) {
+#ifdef FILTER_X86
+	__m128i a = _mm_loadu_si128((const __m128i *) str1);
+	__m128i b = _mm_loadu_si128((const __m128i *) str2);
+	unsigned int equal = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+	unsigned int terminator = _mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128()));
+	unsigned int decided = (~equal | terminator) & 0xFFFF;
+	if (decided == 0)
+		return 0;
+	int pos = __builtin_ctz(decided);
+	return (int) (unsigned char) str1[pos] - (int) (unsigned char) str2[pos];
+#else
+	return strncmp(str1, str2, ATTR_SIZE);
+#endif
+}
+
 /*
  * Compare two attributes based on their type
  * if  attr1  < attr 2 return -1
@@ -1021,7 +1342,7 @@ int deleteAttrCatEntry(recId attrcat_recid) {
  */
 int compareAttributes(union Attribute attr1, union Attribute attr2, int attrType) {
 	if (attrType == STRING) {
-		return strcmp(attr1.sval, attr2.sval);
+		return compareStrings(attr1.sval, attr2.sval);
 	}
 
 	if (attrType == NUMBER) {
@@ -1032,6 +1353,197 @@ int compareAttributes(union Attribute attr1, union Attribute attr2, int attrType
 		else
 			return 1;
 	}
+
+	if (attrType == COMPOSITE) {
+		return memcmp(attr1.sval, attr2.sval, ATTR_SIZE);
+	}
+}
+
+/*
+ * Compares sort keys. Unlike compareAttributes, NaN sorts after every other NUMBER (and equal to another NaN),
+ * which keeps the order consistent for sorting and for the entries of a B+ tree. DESC reverses the order of the
+ * other values, but NaN still sorts last.
+ */
+int compareSortKeys(union Attribute key1, union Attribute key2, int attrType, int order) {
+	if (attrType == NUMBER && (key1.nval != key1.nval || key2.nval != key2.nval))
+		return (key1.nval != key1.nval) - (key2.nval != key2.nval);
+	int flag = compareAttributes(key1, key2, attrType);
+	return (order == DESC) ? -flag : flag;
+}
+
+/*
+ * The predicates below agree with compareAttributes(v, value, NUMBER) followed by a test of its result,
+ * including for NaN: compareAttributes returns 1 for an unordered pair, so GT, GE and NE hold.
+ */
+static bool numberMatches(double v, double value, int op) {
+	switch (op) {
+		case EQ:
+			return v == value;
+		case LT:
+			return v < value;
+		case LE:
+			return v <= value;
+		case GT:
+			return !(v <= value);
+		case GE:
+			return !(v < value);
+		case NE:
+			return !(v == value);
+	}
+	return false;
+}
+
+static void filterNumbersScalar(const union Attribute *column, int from, int numValues, int stride, double value,
+                                int op, uint64_t *mask) {
+	for (int i = from; i < numValues; i++) {
+		if (numberMatches(column[i * stride].nval, value, op))
+			mask[i / 64] |= (uint64_t) 1 << (i % 64);
+	}
+}
+
+#ifdef FILTER_X86
+/*
+ * Two values per compare with SSE2, which every x86-64 processor has.
+ * Returns the number of values evaluated, a multiple of 2.
+ */
+static int filterNumbersSse2(const union Attribute *column, int numValues, int stride, double value, int op,
+                             uint64_t *mask) {
+	__m128d key = _mm_set1_pd(value);
+	int i = 0;
+	for (; i + 2 <= numValues; i += 2) {
+		__m128d v = _mm_setr_pd(column[i * stride].nval, column[(i + 1) * stride].nval);
+		__m128d cmp;
+		switch (op) {
+			case EQ:
+				cmp = _mm_cmpeq_pd(v, key);
+				break;
+			case LT:
+				cmp = _mm_cmplt_pd(v, key);
+				break;
+			case LE:
+				cmp = _mm_cmple_pd(v, key);
+				break;
+			case GT:
+				cmp = _mm_cmpnle_pd(v, key);
+				break;
+			case GE:
+				cmp = _mm_cmpnlt_pd(v, key);
+				break;
+			default:
+				cmp = _mm_cmpneq_pd(v, key);
+				break;
+		}
+		mask[i / 64] |= (uint64_t) _mm_movemask_pd(cmp) << (i % 64);
+	}
+	return i;
+}
+
+/*
+ * Four values per compare, gathered from the strided column with AVX2.
+ * The predicate is a template parameter because _mm256_cmp_pd takes it as an immediate.
+ * Returns the number of values evaluated, a multiple of 4.
+ */
+template<int predicate>
+__attribute__((target("avx2"))) static int filterNumbersAvx2(const union Attribute *column, int numValues,
+                                                              int stride, double value, uint64_t *mask) {
+	const double *base = &column[0].nval;
+	// an Attribute is two doubles wide, so value i is 2 * stride * i doubles from the start of the column
+	long long step = 2LL * stride;
+	__m256i index = _mm256_setr_epi64x(0, step, 2 * step, 3 * step);
+	__m256d key = _mm256_set1_pd(value);
+	int i = 0;
+	for (; i + 4 <= numValues; i += 4) {
+		__m256d v = _mm256_i64gather_pd(base + i * step, index, 8);
+		__m256d cmp = _mm256_cmp_pd(v, key, predicate);
+		mask[i / 64] |= (uint64_t) _mm256_movemask_pd(cmp) << (i % 64);
+	}
+	return i;
+}
+
+static int filterNumbersAvx2(const union Attribute *column, int numValues, int stride, double value, int op,
+                             uint64_t *mask) {
+	switch (op) {
+		case EQ:
+			return filterNumbersAvx2<_CMP_EQ_OQ>(column, numValues, stride, value, mask);
+		case LT:
+			return filterNumbersAvx2<_CMP_LT_OQ>(column, numValues, stride, value, mask);
+		case LE:
+			return filterNumbersAvx2<_CMP_LE_OQ>(column, numValues, stride, value, mask);
+		case GT:
+			return filterNumbersAvx2<_CMP_NLE_UQ>(column, numValues, stride, value, mask);
+		case GE:
+			return filterNumbersAvx2<_CMP_NLT_UQ>(column, numValues, stride, value, mask);
+		case NE:
+			return filterNumbersAvx2<_CMP_NEQ_UQ>(column, numValues, stride, value, mask);
+	}
+	return 0;
+}
+#endif
+
+/*
+ * Evaluates 'column[i * stride].nval op value' for i in [0, numValues) and sets bit i % 64 of mask[i / 64]
+ * for every value that satisfies it. column usually points at an attribute of the first record of a
+ * RecordBatch, with stride being the number of attributes per record.
+ * mask must hold (numValues + 63) / 64 words, all of which are overwritten.
+ * Returns the number of values selected.
+ */
+int filterNumbers(const union Attribute *column, int numValues, int stride, double value, int op, uint64_t *mask) {
+	memset(mask, 0, ((numValues + 63) / 64) * sizeof(uint64_t));
+
+	int done = 0;
+#ifdef FILTER_X86
+	static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+	if (hasAvx2)
+		done = filterNumbersAvx2(column, numValues, stride, value, op, mask);
+	else
+		done = filterNumbersSse2(column, numValues, stride, value, op, mask);
+#endif
+	filterNumbersScalar(column, done, numValues, stride, value, op, mask);
+
+	int selected = 0;
+	for (int word = 0; word < (numValues + 63) / 64; word++)
+		selected += __builtin_popcountll(mask[word]);
+	return selected;
+}
+
+/*
+ * Same as filterNumbers, for a column of STRING attributes compared with compareStrings.
+ * A STRING value fills a whole SSE register, so compareStrings already takes one vector step per value; the values
+ * of a column lie a record apart and have to be loaded one at a time anyway, so this stays a loop over them.
+ */
+int filterStrings(const union Attribute *column, int numValues, int stride, const char *value, int op, uint64_t *mask) {
+	memset(mask, 0, ((numValues + 63) / 64) * sizeof(uint64_t));
+
+	int selected = 0;
+	for (int i = 0; i < numValues; i++) {
+		int flag = compareStrings(column[i * stride].sval, value);
+		bool cond;
+		switch (op) {
+			case EQ:
+				cond = (flag == 0);
+				break;
+			case LT:
+				cond = (flag < 0);
+				break;
+			case LE:
+				cond = (flag <= 0);
+				break;
+			case GT:
+				cond = (flag > 0);
+				break;
+			case GE:
+				cond = (flag >= 0);
+				break;
+			default:
+				cond = (flag != 0);
+				break;
+		}
+		if (cond) {
+			mask[i / 64] |= (uint64_t) 1 << (i % 64);
+			selected++;
+		}
+	}
+	return selected;
 }
 
 InternalEntry getInternalEntry(int block, int entryNum) {
@@ -1089,6 +1601,24 @@ Index getLeafEntry(int leaf, int offset) {
 	return rec;
 }
 
+/*
+ * Reads all entries of the leaf index block 'leaf' with a single read and returns their number
+ */
+int getLeafEntries(Index *entries, int leaf) {
+	unsigned char block[BLOCK_SIZE];
+	FILE *disk = fopen(&DISK_PATH[0], "rb");
+	fseek(disk, leaf * BLOCK_SIZE, SEEK_SET);
+	fread(block, BLOCK_SIZE, 1, disk);
+	fclose(disk);
+
+	HeadInfo header;
+	memcpy(&header, block, HEADER_SIZE);
+	if (header.numEntries < 0 || header.numEntries > (BLOCK_SIZE - HEADER_SIZE) / LEAF_ENTRY_SIZE)
+		return FAILURE;
+	memcpy(entries, block + HEADER_SIZE, header.numEntries * LEAF_ENTRY_SIZE);
+	return header.numEntries;
+}
+
 void setLeafEntry(Index rec, int leaf, int offset) {
 	FILE *disk = fopen(&DISK_PATH[0], "rb+");
 	fseek(disk, leaf * BLOCK_SIZE + HEADER_SIZE + offset * LEAF_ENTRY_SIZE, SEEK_SET);
@@ -1,9 +1,31 @@
 #ifndef NITCBASE_BLOCK_ACCESS_H
 #define NITCBASE_BLOCK_ACCESS_H
 
+#include <vector>
 #include "disk_structures.h"
+#include "block_allocation.h"
+#include "composite_index.h"
+
+/*
+ * A bulk insert into an open relation. ba_bulkInsert writes batches of records straight into whole record blocks,
+ * and collects the entries the records need in the indexes of the relation. ba_endBulkInsert adds them to each
+ * index at once, in sorted order.
+ */
+typedef struct BulkInsert {
+	int relId;
+	int numExisting;
+	std::vector<int> attrOffsets;
+	std::vector<std::vector<Index>> attrEntries;
+	std::vector<CompositeIndex> compositeIndexes;
+	std::vector<std::vector<Index>> compositeEntries;
+} BulkInsert;
 
 int ba_insert(int relId, Attribute *rec);
+int ba_beginBulkInsert(int relId, BulkInsert *bulk);
+int ba_bulkInsert(BulkInsert *bulk, Attribute *records, int numRecords);
+int ba_endBulkInsert(BulkInsert *bulk);
+int ba_deleteRecord(int relId, recId recid);
+int ba_updateRecord(int relId, recId recid, Attribute *newRec);
 int ba_search(relId relid, union Attribute *record, char attrName[ATTR_SIZE], union Attribute attrval, int op, recId *prev_recid);
 recId linear_search(relId relid, char attrName[ATTR_SIZE], union Attribute attrval, int op, recId *prev_recid);
 int ba_renamerel(char oldName[ATTR_SIZE], char newName[ATTR_SIZE]);
@@ -17,21 +39,25 @@ void getSlotmap(unsigned char *SlotMap, int blockNum);
 void setSlotmap(unsigned char *SlotMap, int no_of_slots, int blockNum);
 int getRecord(Attribute *rec, int blockNum, int slotNum);
 int setRecord(Attribute *rec, int blockNum, int slotNum);
+int getRecordBatch(RecordBatch *batch, int blockNum);
+int getIndexedRecords(Attribute *records, int numAttrs, const Index *entries, int numEntries);
 int getRelCatEntry(int relationId, Attribute *relcat_entry);
 int getAttrCatEntry(int relationId, char attrname[16], Attribute *attrcat_entry);
 int getAttrCatEntry(int relationId, int offset, Attribute *attrCatEntry);
 int setRelCatEntry(int relationId, Attribute *relcat_entry);
 int setAttrCatEntry(int relationId, char attrName[ATTR_SIZE], Attribute *attrCatEntry);
 
-int getFreeBlock(int block_type);
-int getBlockType(int blocknum);
 //InternalEntry getEntry(int block, int entry_number);
 int compareAttributes(union Attribute attr1, union Attribute attr2, int attrType);
+int compareSortKeys(union Attribute key1, union Attribute key2, int attrType, int order);
+int filterNumbers(const union Attribute *column, int numValues, int stride, double value, int op, uint64_t *mask);
+int filterStrings(const union Attribute *column, int numValues, int stride, const char *value, int op, uint64_t *mask);
 int deleteBlock(int blockNum);
 
 InternalEntry getInternalEntry(int block, int entryNum);
 void setInternalEntry(InternalEntry internalEntry, int block, int offset);
 Index getLeafEntry(int leaf, int offset);
+int getLeafEntries(Index *entries, int leaf);
 void setLeafEntry(Index rec, int leaf, int offset);
 
 #endif //NITCBASE_BLOCK_ACCESS_H
@@ -0,0 +1,173 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include "define/constants.h"
+#include "define/errors.h"
+#include "block_allocation.h"
+
+/*
+ * In-memory copy of the Block Allocation Map (blocks 0 to BLOCK_ALLOCATION_MAP_SIZE-1 of the disk).
+ * It is read from the disk on first use, and every change is written through to the disk
+ * by rewriting only the bytes of the map that changed.
+ * freeBitmap has bit (blockNum % 64) of word (blockNum / 64) set when the block is UNUSED_BLK,
+ * so a search skips 64 allocated blocks at a time.
+ */
+static unsigned char blockAllocationMap[DISK_BLOCKS];
+static uint64_t freeBitmap[DISK_BLOCKS / 64];
+static bool blockAllocationMapLoaded = false;
+static int nextFitHint = 0;
+
+static int loadBlockAllocationMap() {
+	if (blockAllocationMapLoaded)
+		return SUCCESS;
+
+	FILE *disk = fopen(&DISK_PATH[0], "rb");
+	if (disk == nullptr)
+		return FAILURE;
+	fseek(disk, 0, SEEK_SET);
+	size_t read = fread(blockAllocationMap, DISK_BLOCKS, 1, disk);
+	fclose(disk);
+	if (read != 1)
+		return FAILURE;
+
+	memset(freeBitmap, 0, sizeof(freeBitmap));
+	for (int blockNum = 0; blockNum < DISK_BLOCKS; blockNum++) {
+		if ((int32_t) (blockAllocationMap[blockNum]) == UNUSED_BLK)
+			freeBitmap[blockNum / 64] |= (uint64_t) 1 << (blockNum % 64);
+	}
+	nextFitHint = 0;
+	blockAllocationMapLoaded = true;
+	return SUCCESS;
+}
+
+/*
+ * Writes entries [blockNum, blockNum + numBlocks) of the cached map through to the disk
+ */
+static void writeBlockAllocationMap(int blockNum, int numBlocks) {
+	FILE *disk = fopen(&DISK_PATH[0], "rb+");
+	if (disk == nullptr)
+		return;
+	fseek(disk, blockNum, SEEK_SET);
+	fwrite(blockAllocationMap + blockNum, numBlocks, 1, disk);
+	fclose(disk);
+}
+
+static void markBlocks(int blockNum, int numBlocks, int block_type) {
+	for (int iter = blockNum; iter < blockNum + numBlocks; iter++) {
+		blockAllocationMap[iter] = (unsigned char) block_type;
+		if (block_type == UNUSED_BLK)
+			freeBitmap[iter / 64] |= (uint64_t) 1 << (iter % 64);
+		else
+			freeBitmap[iter / 64] &= ~((uint64_t) 1 << (iter % 64));
+	}
+	writeBlockAllocationMap(blockNum, numBlocks);
+}
+
+/*
+ * Returns the first free block at or after 'from', or -1 if there is none before the end of the disk
+ */
+static int nextFreeBlock(int from) {
+	if (from >= DISK_BLOCKS)
+		return -1;
+	int word = from / 64;
+	uint64_t bits = freeBitmap[word] & (~(uint64_t) 0 << (from % 64));
+	while (bits == 0) {
+		word++;
+		if (word == DISK_BLOCKS / 64)
+			return -1;
+		bits = freeBitmap[word];
+	}
+	return word * 64 + __builtin_ctzll(bits);
+}
+
+/*
+ * Returns the first allocated block at or after 'from', or DISK_BLOCKS if the rest of the disk is free
+ */
+static int nextUsedBlock(int from) {
+	if (from >= DISK_BLOCKS)
+		return DISK_BLOCKS;
+	int word = from / 64;
+	uint64_t bits = ~freeBitmap[word] & (~(uint64_t) 0 << (from % 64));
+	while (bits == 0) {
+		word++;
+		if (word == DISK_BLOCKS / 64)
+			return DISK_BLOCKS;
+		bits = ~freeBitmap[word];
+	}
+	return word * 64 + __builtin_ctzll(bits);
+}
+
+/*
+ * Finds the first run of numBlocks free blocks starting in [from, to), or returns -1
+ */
+static int findFreeExtent(int from, int to, int numBlocks) {
+	int start = nextFreeBlock(from);
+	while (start != -1 && start < to) {
+		int end = nextUsedBlock(start);
+		if (end - start >= numBlocks)
+			return start;
+		start = nextFreeBlock(end);
+	}
+	return -1;
+}
+
+/*
+ * Allocates numBlocks physically contiguous blocks of the given type and returns the first of them.
+ * The search is next-fit: it resumes after the last allocation and wraps around once,
+ * so consecutive allocations (eg. bulk loads, B+ tree splits) get neighbouring blocks.
+ * Returns E_DISKFULL if no run of numBlocks free blocks exists.
+ */
+int getFreeBlocks(int block_type, int numBlocks) {
+	if (numBlocks <= 0 || numBlocks > DISK_BLOCKS)
+		return E_INVALID;
+	if (loadBlockAllocationMap() != SUCCESS)
+		return FAILURE;
+
+	int start = findFreeExtent(nextFitHint, DISK_BLOCKS, numBlocks);
+	if (start == -1)
+		start = findFreeExtent(0, nextFitHint, numBlocks);
+	if (start == -1)
+		return E_DISKFULL;
+
+	markBlocks(start, numBlocks, block_type);
+	nextFitHint = (start + numBlocks) % DISK_BLOCKS;
+	return start;
+}
+
+int getFreeBlock(int block_type) {
+	int blockNum = getFreeBlocks(block_type, 1);
+	return blockNum >= 0 ? blockNum : FAILURE;
+}
+
+int getFreeRecBlock() {
+	return getFreeBlock(REC);
+}
+
+/*
+ * Retrieves whether the block is occupied or not
+ * If occupied returns the type of occupied block (REC: 0, IND_INTERNAL: 1, IND_LEAF: 2)
+ * If Not returns UNUSED_BLK: 3
+ */
+int getBlockType(int blocknum) {
+	if (blocknum < 0 || blocknum >= DISK_BLOCKS)
+		return E_OUTOFBOUND;
+	if (loadBlockAllocationMap() != SUCCESS)
+		return FAILURE;
+	return (int32_t) (blockAllocationMap[blocknum]);
+}
+
+/*
+ * Marks the block UNUSED_BLK in the Block Allocation Map
+ */
+void releaseBlockAllocation(int blockNum) {
+	if (blockNum < 0 || blockNum >= DISK_BLOCKS || loadBlockAllocationMap() != SUCCESS)
+		return;
+	markBlocks(blockNum, 1, UNUSED_BLK);
+}
+
+/*
+ * Drops the cached map, so it is read again from the disk on next use (eg. after the disk is formatted)
+ */
+void invalidateBlockAllocationMap() {
+	blockAllocationMapLoaded = false;
+}
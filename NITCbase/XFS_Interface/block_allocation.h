@@ -0,0 +1,11 @@
+#ifndef NITCBASE_BLOCK_ALLOCATION_H
+#define NITCBASE_BLOCK_ALLOCATION_H
+
+int getFreeBlock(int block_type);
+int getFreeBlocks(int block_type, int numBlocks);
+int getFreeRecBlock();
+int getBlockType(int blocknum);
+void releaseBlockAllocation(int blockNum);
+void invalidateBlockAllocationMap();
+
+#endif //NITCBASE_BLOCK_ALLOCATION_H
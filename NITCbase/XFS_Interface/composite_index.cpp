@@ -0,0 +1,550 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include "define/constants.h"
+#include "define/errors.h"
+#include "disk_structures.h"
+#include "composite_index.h"
+#include "block_access.h"
+#include "BPlusTree.h"
+#include "OpenRelTable.h"
+#include "schema.h"
+
+/*
+ * In-memory copy of the entries of the Index Catalog (the INDEXCAT_RELNAME relation).
+ * It is read from the disk on first use, and reloaded after any change to the catalog.
+ * The offsets and types of the attributes of an entry are looked up the first time the entry is used.
+ */
+static std::vector<CompositeIndex> indexCatalog;
+static bool indexCatalogLoaded = false;
+
+/*
+ * Encodes the values of the attributes of a composite index into a key whose bytes, compared with memcmp,
+ * order keys like the values compared one attribute after the other:
+ *  - a NUMBER is the 8 bytes of the double, most significant first, with the sign bit set for a positive number
+ *    and all bits flipped for a negative one (-0 is encoded as 0, and NaN after every other number)
+ *  - a STRING is its characters followed by a NUL byte, which sorts before every character
+ * The key is cut off at ATTR_SIZE bytes, making a composite index a prefix index (see COMPOSITE_INDEX_MAX_ATTRS):
+ * records whose values share a long enough prefix may get equal keys, and the records found through a composite
+ * index have to be checked against the values searched for.
+ * The bytes after the last value are set to pad: 0 gives the smallest key starting with the values, and 0xFF
+ * the largest one.
+ * Returns the number of values that were encoded whole
+ */
+int encodeCompositeKey(const Attribute *values, const int *types, int numValues, unsigned char pad, Attribute *key) {
+	unsigned char *bytes = (unsigned char *) key->sval;
+	int length = 0, numEncoded = 0;
+
+	for (int iter = 0; iter < numValues && length < ATTR_SIZE; iter++) {
+		unsigned char encoded[ATTR_SIZE + 1];
+		int size;
+		if (types[iter] == NUMBER) {
+			double value = values[iter].nval;
+			uint64_t bits;
+			if (value == 0)
+				value = 0;
+			memcpy(&bits, &value, sizeof(bits));
+			if (value != value)
+				bits = 0x7FF8000000000000ULL;
+			bits = (bits >> 63) ? ~bits : bits | (1ULL << 63);
+			for (int byte = 0; byte < 8; byte++)
+				encoded[byte] = (unsigned char) (bits >> (56 - 8 * byte));
+			size = 8;
+		} else {
+			size = strnlen(values[iter].sval, ATTR_SIZE);
+			memcpy(encoded, values[iter].sval, size);
+			encoded[size++] = '\0';
+		}
+
+		int copied = std::min(size, ATTR_SIZE - length);
+		memcpy(bytes + length, encoded, copied);
+		length += copied;
+		if (copied == size)
+			numEncoded++;
+	}
+	memset(bytes + length, pad, ATTR_SIZE - length);
+	return numEncoded;
+}
+
+/*
+ * Returns the relation catalog entry of the Index Catalog in relCatEntry, and its record id,
+ * or {-1, -1} if no composite index has been created on the disk yet.
+ * A relation of that name whose records are not laid out as Index Catalog entries is not read as the catalog.
+ */
+static recId getIndexCatRelCatEntry(Attribute relCatEntry[RELCAT_NO_ATTRS]) {
+	Attribute relName;
+	strcpy(relName.sval, INDEXCAT_RELNAME);
+	recId prev_recid = {-1, -1};
+	recId relcat_recid = linear_search(RELCAT_RELID, RELCAT_ATTR_RELNAME, relName, EQ, &prev_recid);
+	if (relcat_recid.block == -1 && relcat_recid.slot == -1)
+		return relcat_recid;
+
+	getRecord(relCatEntry, relcat_recid.block, relcat_recid.slot);
+	if ((int) relCatEntry[RELCAT_NO_ATTRIBUTES_INDEX].nval != INDEXCAT_NO_ATTRS)
+		return {-1, -1};
+	return relcat_recid;
+}
+
+static void loadIndexCatalog() {
+	if (indexCatalogLoaded)
+		return;
+
+	indexCatalog.clear();
+	Attribute relCatEntry[RELCAT_NO_ATTRS];
+	recId relcat_recid = getIndexCatRelCatEntry(relCatEntry);
+	int block = -1;
+	if (relcat_recid.block != -1 || relcat_recid.slot != -1)
+		block = (int) relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval;
+
+	RecordBatch batch;
+	while (block != -1) {
+		if (getRecordBatch(&batch, block) != SUCCESS)
+			break;
+		for (int iter = 0; iter < batch.numRecords; iter++) {
+			Attribute *record = batch.records + iter * INDEXCAT_NO_ATTRS;
+			CompositeIndex index;
+			memset(&index, 0, sizeof(index));
+			strcpy(index.relName, record[INDEXCAT_REL_NAME_INDEX].sval);
+			index.numAttrs = (int) record[INDEXCAT_NO_ATTRIBUTES_INDEX].nval;
+			index.rootBlock = (int) record[INDEXCAT_ROOT_BLOCK_INDEX].nval;
+			for (int attr = 0; attr < index.numAttrs; attr++) {
+				strcpy(index.attrNames[attr], record[INDEXCAT_ATTR_NAME_INDEX + attr].sval);
+				index.attrOffsets[attr] = -1;
+			}
+			index.catalogRecId = {block, batch.slotNums[iter]};
+			indexCatalog.push_back(index);
+		}
+		block = batch.header.rblock;
+	}
+	indexCatalogLoaded = true;
+}
+
+void invalidateIndexCatalog() {
+	indexCatalog.clear();
+	indexCatalogLoaded = false;
+}
+
+/*
+ * Fills in the offsets and types of the attributes of a composite index on the open relation relId
+ */
+static int resolveAttributes(int relId, CompositeIndex &index) {
+	int offsets[COMPOSITE_INDEX_MAX_ATTRS], types[COMPOSITE_INDEX_MAX_ATTRS];
+	for (int attr = 0; attr < index.numAttrs; attr++) {
+		Attribute attrCatEntry[ATTRCAT_NO_ATTRS];
+		int flag = getAttrCatEntry(relId, index.attrNames[attr], attrCatEntry);
+		if (flag != SUCCESS)
+			return flag;
+		offsets[attr] = (int) attrCatEntry[ATTRCAT_OFFSET_INDEX].nval;
+		types[attr] = (int) attrCatEntry[ATTRCAT_ATTR_TYPE_INDEX].nval;
+	}
+	memcpy(index.attrOffsets, offsets, index.numAttrs * sizeof(int));
+	memcpy(index.attrTypes, types, index.numAttrs * sizeof(int));
+	return SUCCESS;
+}
+
+static bool hasAttributes(const CompositeIndex &index, int numAttrs, char attrNames[][ATTR_SIZE]) {
+	if (index.numAttrs != numAttrs)
+		return false;
+	for (int attr = 0; attr < numAttrs; attr++) {
+		if (strcmp(index.attrNames[attr], attrNames[attr]) != 0)
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Tells from the in-memory catalog alone whether the open relation relId has any composite index, so that the
+ * records of the other relations are inserted, deleted and updated without looking up their indexes
+ */
+static bool hasCompositeIndexes(int relId) {
+	if (relId == RELCAT_RELID || relId == ATTRCAT_RELID)
+		return false;
+	loadIndexCatalog();
+	if (indexCatalog.empty())
+		return false;
+
+	char relName[ATTR_SIZE];
+	if (OpenRelTable::getRelationName(relId, relName) != SUCCESS)
+		return false;
+	for (auto &index : indexCatalog) {
+		if (strcmp(index.relName, relName) == 0)
+			return true;
+	}
+	return false;
+}
+
+/*
+ * Returns the composite indexes of the open relation relId in indexes
+ */
+int getCompositeIndexes(int relId, std::vector<CompositeIndex> &indexes) {
+	char relName[ATTR_SIZE];
+	if (OpenRelTable::getRelationName(relId, relName) != SUCCESS)
+		return E_RELNOTOPEN;
+
+	loadIndexCatalog();
+	for (auto &index : indexCatalog) {
+		if (strcmp(index.relName, relName) != 0)
+			continue;
+		if (index.attrOffsets[0] == -1 && resolveAttributes(relId, index) != SUCCESS)
+			continue;
+		indexes.push_back(index);
+	}
+	return SUCCESS;
+}
+
+/*
+ * Adds an entry for the composite index to the Index Catalog, creating its relation if it does not exist
+ */
+static int addIndexCatEntry(const CompositeIndex &index) {
+	char relName[ATTR_SIZE] = INDEXCAT_RELNAME;
+	Attribute relCatEntry[RELCAT_NO_ATTRS];
+	recId relcat_recid = getIndexCatRelCatEntry(relCatEntry);
+	if (relcat_recid.block == -1 && relcat_recid.slot == -1) {
+		char attrNames[INDEXCAT_NO_ATTRS][ATTR_SIZE];
+		int attrTypes[INDEXCAT_NO_ATTRS];
+		strcpy(attrNames[INDEXCAT_REL_NAME_INDEX], INDEXCAT_ATTR_RELNAME);
+		attrTypes[INDEXCAT_REL_NAME_INDEX] = STRING;
+		strcpy(attrNames[INDEXCAT_NO_ATTRIBUTES_INDEX], INDEXCAT_ATTR_NO_ATTRIBUTES);
+		attrTypes[INDEXCAT_NO_ATTRIBUTES_INDEX] = NUMBER;
+		strcpy(attrNames[INDEXCAT_ROOT_BLOCK_INDEX], INDEXCAT_ATTR_ROOT_BLOCK);
+		attrTypes[INDEXCAT_ROOT_BLOCK_INDEX] = NUMBER;
+		for (int attr = 0; attr < COMPOSITE_INDEX_MAX_ATTRS; attr++) {
+			sprintf(attrNames[INDEXCAT_ATTR_NAME_INDEX + attr], "%s%d", INDEXCAT_ATTR_ATTRIBUTE_NAME, attr + 1);
+			attrTypes[INDEXCAT_ATTR_NAME_INDEX + attr] = STRING;
+		}
+		int ret = createRel(relName, INDEXCAT_NO_ATTRS, attrNames, attrTypes);
+		if (ret != SUCCESS)
+			return ret;
+	}
+
+	bool wasOpen = (OpenRelTable::checkIfRelationOpen(relName) == SUCCESS);
+	int relId = OpenRelTable::openRelation(relName);
+	if (relId < 0)
+		return relId;
+
+	Attribute record[INDEXCAT_NO_ATTRS];
+	memset(record, 0, sizeof(record));
+	strcpy(record[INDEXCAT_REL_NAME_INDEX].sval, index.relName);
+	record[INDEXCAT_NO_ATTRIBUTES_INDEX].nval = index.numAttrs;
+	record[INDEXCAT_ROOT_BLOCK_INDEX].nval = index.rootBlock;
+	for (int attr = 0; attr < index.numAttrs; attr++)
+		strcpy(record[INDEXCAT_ATTR_NAME_INDEX + attr].sval, index.attrNames[attr]);
+	int ret = ba_insert(relId, record);
+
+	if (!wasOpen)
+		OpenRelTable::closeRelation(relId);
+	invalidateIndexCatalog();
+	return ret;
+}
+
+/*
+ * Frees the slot of an entry of the Index Catalog, releasing its block once the last entry in it is gone
+ */
+static void deleteIndexCatEntry(recId catalogRecId) {
+	HeadInfo header = getHeader(catalogRecId.block);
+	unsigned char slotmap[header.numSlots];
+	getSlotmap(slotmap, catalogRecId.block);
+	slotmap[catalogRecId.slot] = SLOT_UNOCCUPIED;
+	setSlotmap(slotmap, header.numSlots, catalogRecId.block);
+	header.numEntries = header.numEntries - 1;
+	setHeader(&header, catalogRecId.block);
+
+	Attribute relCatEntry[RELCAT_NO_ATTRS];
+	recId relcat_recid = getIndexCatRelCatEntry(relCatEntry);
+	char relName[ATTR_SIZE] = INDEXCAT_RELNAME;
+	int relId = OpenRelTable::getRelationId(relName);
+	if (header.numEntries == 0) {
+		if (header.lblock != -1) {
+			HeadInfo prev_header = getHeader(header.lblock);
+			prev_header.rblock = header.rblock;
+			setHeader(&prev_header, header.lblock);
+		} else {
+			relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval = header.rblock;
+		}
+		if (header.rblock != -1) {
+			HeadInfo next_header = getHeader(header.rblock);
+			next_header.lblock = header.lblock;
+			setHeader(&next_header, header.rblock);
+		} else {
+			relCatEntry[RELCAT_LAST_BLOCK_INDEX].nval = header.lblock;
+		}
+		OpenRelTable::setFreeSpace(relId, catalogRecId.block, false);
+		deleteBlock(catalogRecId.block);
+	} else {
+		OpenRelTable::setFreeSpace(relId, catalogRecId.block, true);
+	}
+
+	relCatEntry[RELCAT_NO_RECORDS_INDEX].nval = relCatEntry[RELCAT_NO_RECORDS_INDEX].nval - 1;
+	setRecord(relCatEntry, relcat_recid.block, relcat_recid.slot);
+
+	invalidateIndexCatalog();
+}
+
+static void setIndexCatRootBlock(recId catalogRecId, int rootBlock) {
+	Attribute record[INDEXCAT_NO_ATTRS];
+	getRecord(record, catalogRecId.block, catalogRecId.slot);
+	record[INDEXCAT_ROOT_BLOCK_INDEX].nval = rootBlock;
+	setRecord(record, catalogRecId.block, catalogRecId.slot);
+
+	for (auto &index : indexCatalog) {
+		if (index.catalogRecId.block == catalogRecId.block && index.catalogRecId.slot == catalogRecId.slot)
+			index.rootBlock = rootBlock;
+	}
+}
+
+/*
+ * Creates a composite index on the given attributes of the open relation relId, bulk loading its B+ tree
+ * from the keys of all the records of the relation.
+ * Returns the root block of the index, or E_INDEXEXISTS if the relation already has an index on the attributes
+ */
+int createCompositeIndex(int relId, int numAttrs, char attrNames[][ATTR_SIZE]) {
+	if (numAttrs < 1 || numAttrs > COMPOSITE_INDEX_MAX_ATTRS)
+		return E_INVALID;
+
+	std::vector<CompositeIndex> indexes;
+	int flag = getCompositeIndexes(relId, indexes);
+	if (flag != SUCCESS)
+		return flag;
+	for (auto &existing : indexes) {
+		if (hasAttributes(existing, numAttrs, attrNames))
+			return E_INDEXEXISTS;
+	}
+
+	CompositeIndex index;
+	memset(&index, 0, sizeof(index));
+	OpenRelTable::getRelationName(relId, index.relName);
+	index.numAttrs = numAttrs;
+	for (int attr = 0; attr < numAttrs; attr++)
+		strcpy(index.attrNames[attr], attrNames[attr]);
+	if (resolveAttributes(relId, index) != SUCCESS)
+		return E_ATTRNOTEXIST;
+
+	Attribute relCatEntry[RELCAT_NO_ATTRS];
+	getRelCatEntry(relId, relCatEntry);
+	int dataBlock = (int) relCatEntry[RELCAT_FIRST_BLOCK_INDEX].nval;
+	int relNumAttrs = (int) relCatEntry[RELCAT_NO_ATTRIBUTES_INDEX].nval;
+
+	// collect an index entry for each record of the relation, and sort them on their keys
+	std::vector<Index> entries;
+	entries.reserve((size_t) relCatEntry[RELCAT_NO_RECORDS_INDEX].nval);
+	RecordBatch batch;
+	Attribute values[COMPOSITE_INDEX_MAX_ATTRS];
+	while (dataBlock != -1) {
+		if (getRecordBatch(&batch, dataBlock) != SUCCESS)
+			break;
+
+		for (int iter = 0; iter < batch.numRecords; iter++) {
+			for (int attr = 0; attr < numAttrs; attr++)
+				values[attr] = batch.records[iter * relNumAttrs + index.attrOffsets[attr]];
+			Index entry;
+			memset(&entry, 0, sizeof(entry));
+			encodeCompositeKey(values, index.attrTypes, numAttrs, 0, &entry.attrVal);
+			entry.block = dataBlock;
+			entry.slot = batch.slotNums[iter];
+			entries.push_back(entry);
+		}
+		dataBlock = batch.header.rblock;
+	}
+	std::stable_sort(entries.begin(), entries.end(), [](const Index &entry1, const Index &entry2) {
+		return compareAttributes(entry1.attrVal, entry2.attrVal, COMPOSITE) < 0;
+	});
+
+	int rootBlock = BPlusTree::bPlusBulkLoad(entries.data(), entries.size());
+	if (rootBlock < 0)
+		return rootBlock;
+
+	index.rootBlock = rootBlock;
+	int ret = addIndexCatEntry(index);
+	if (ret != SUCCESS) {
+		BPlusTree::bPlusDestroy(rootBlock);
+		return ret;
+	}
+	return rootBlock;
+}
+
+/*
+ * Destroys the composite index on the given attributes of the open relation relId
+ */
+int dropCompositeIndex(int relId, int numAttrs, char attrNames[][ATTR_SIZE]) {
+	std::vector<CompositeIndex> indexes;
+	int flag = getCompositeIndexes(relId, indexes);
+	if (flag != SUCCESS)
+		return flag;
+
+	for (auto &index : indexes) {
+		if (hasAttributes(index, numAttrs, attrNames)) {
+			BPlusTree::bPlusDestroy(index.rootBlock);
+			deleteIndexCatEntry(index.catalogRecId);
+			return SUCCESS;
+		}
+	}
+	return E_NOINDEX;
+}
+
+/*
+ * Inserts the key of a record just inserted into the open relation relId into every composite index of the
+ * relation. An index whose B+ tree had to be destroyed because the disk is full is dropped from the catalog.
+ */
+int insertIntoCompositeIndexes(int relId, Attribute *record, recId recordId) {
+	if (!hasCompositeIndexes(relId))
+		return SUCCESS;
+
+	std::vector<CompositeIndex> indexes;
+	int retVal = getCompositeIndexes(relId, indexes);
+	if (retVal != SUCCESS)
+		return retVal;
+
+	Attribute values[COMPOSITE_INDEX_MAX_ATTRS];
+	for (auto &index : indexes) {
+		for (int attr = 0; attr < index.numAttrs; attr++)
+			values[attr] = record[index.attrOffsets[attr]];
+		Attribute key;
+		encodeCompositeKey(values, index.attrTypes, index.numAttrs, 0, &key);
+
+		int rootBlock = index.rootBlock;
+		int ret = BPlusTree::insertEntry(&rootBlock, COMPOSITE, key, recordId);
+		if (rootBlock == -1)
+			deleteIndexCatEntry(index.catalogRecId);
+		else if (rootBlock != index.rootBlock)
+			setIndexCatRootBlock(index.catalogRecId, rootBlock);
+		if (ret != SUCCESS)
+			retVal = ret;
+	}
+	return retVal;
+}
+
+/*
+ * Adds the entries of a batch of records (keyed by encodeCompositeKey) to a composite index from getCompositeIndexes
+ * with BPlusTree::insertEntries, numExisting being about the number of entries the index already has
+ */
+int insertEntriesIntoCompositeIndex(const CompositeIndex &index, Index *entries, int numEntries, int numExisting) {
+	int rootBlock = index.rootBlock;
+	int ret = BPlusTree::insertEntries(&rootBlock, COMPOSITE, entries, numEntries, numExisting);
+	if (rootBlock == -1)
+		deleteIndexCatEntry(index.catalogRecId);
+	else if (rootBlock != index.rootBlock)
+		setIndexCatRootBlock(index.catalogRecId, rootBlock);
+	return ret;
+}
+
+/*
+ * Removes the key of a record about to be deleted from the open relation relId from every composite index of
+ * the relation
+ */
+int deleteFromCompositeIndexes(int relId, Attribute *record, recId recordId) {
+	if (!hasCompositeIndexes(relId))
+		return SUCCESS;
+
+	std::vector<CompositeIndex> indexes;
+	int retVal = getCompositeIndexes(relId, indexes);
+	if (retVal != SUCCESS)
+		return retVal;
+
+	Attribute values[COMPOSITE_INDEX_MAX_ATTRS];
+	for (auto &index : indexes) {
+		for (int attr = 0; attr < index.numAttrs; attr++)
+			values[attr] = record[index.attrOffsets[attr]];
+		Attribute key;
+		encodeCompositeKey(values, index.attrTypes, index.numAttrs, 0, &key);
+
+		int rootBlock = index.rootBlock;
+		int ret = BPlusTree::deleteEntry(&rootBlock, COMPOSITE, key, recordId);
+		if (rootBlock != index.rootBlock)
+			setIndexCatRootBlock(index.catalogRecId, rootBlock);
+		if (ret != SUCCESS)
+			retVal = ret;
+	}
+	return retVal;
+}
+
+/*
+ * Replaces the key of a record of the open relation relId that was updated in place, in every composite index of
+ * the relation whose key it changed. As on insert, an index destroyed because the disk is full is dropped.
+ */
+int updateCompositeIndexes(int relId, Attribute *oldRecord, Attribute *newRecord, recId recordId) {
+	if (!hasCompositeIndexes(relId))
+		return SUCCESS;
+
+	std::vector<CompositeIndex> indexes;
+	int retVal = getCompositeIndexes(relId, indexes);
+	if (retVal != SUCCESS)
+		return retVal;
+
+	Attribute values[COMPOSITE_INDEX_MAX_ATTRS];
+	for (auto &index : indexes) {
+		Attribute oldKey, newKey;
+		for (int attr = 0; attr < index.numAttrs; attr++)
+			values[attr] = oldRecord[index.attrOffsets[attr]];
+		encodeCompositeKey(values, index.attrTypes, index.numAttrs, 0, &oldKey);
+		for (int attr = 0; attr < index.numAttrs; attr++)
+			values[attr] = newRecord[index.attrOffsets[attr]];
+		encodeCompositeKey(values, index.attrTypes, index.numAttrs, 0, &newKey);
+		if (memcmp(&oldKey, &newKey, ATTR_SIZE) == 0)
+			continue;
+
+		int rootBlock = index.rootBlock;
+		// the new key is inserted even if the old one is missing, so that the record can still be found
+		int ret = BPlusTree::deleteEntry(&rootBlock, COMPOSITE, oldKey, recordId);
+		int insertRet = BPlusTree::insertEntry(&rootBlock, COMPOSITE, newKey, recordId);
+		if (ret == SUCCESS)
+			ret = insertRet;
+		if (rootBlock == -1)
+			deleteIndexCatEntry(index.catalogRecId);
+		else if (rootBlock != index.rootBlock)
+			setIndexCatRootBlock(index.catalogRecId, rootBlock);
+		if (ret != SUCCESS)
+			retVal = ret;
+	}
+	return retVal;
+}
+
+/*
+ * Destroys all the composite indexes of a relation that is being deleted
+ */
+int deleteCompositeIndexes(char relName[ATTR_SIZE]) {
+	loadIndexCatalog();
+	std::vector<CompositeIndex> indexes;
+	for (auto &index : indexCatalog) {
+		if (strcmp(index.relName, relName) == 0)
+			indexes.push_back(index);
+	}
+
+	for (auto &index : indexes) {
+		BPlusTree::bPlusDestroy(index.rootBlock);
+		deleteIndexCatEntry(index.catalogRecId);
+	}
+	return SUCCESS;
+}
+
+int renameCompositeIndexRelation(char oldName[ATTR_SIZE], char newName[ATTR_SIZE]) {
+	loadIndexCatalog();
+	Attribute record[INDEXCAT_NO_ATTRS];
+	for (auto &index : indexCatalog) {
+		if (strcmp(index.relName, oldName) != 0)
+			continue;
+		getRecord(record, index.catalogRecId.block, index.catalogRecId.slot);
+		strcpy(record[INDEXCAT_REL_NAME_INDEX].sval, newName);
+		setRecord(record, index.catalogRecId.block, index.catalogRecId.slot);
+	}
+	invalidateIndexCatalog();
+	return SUCCESS;
+}
+
+int renameCompositeIndexAttribute(char relName[ATTR_SIZE], char oldName[ATTR_SIZE], char newName[ATTR_SIZE]) {
+	loadIndexCatalog();
+	Attribute record[INDEXCAT_NO_ATTRS];
+	for (auto &index : indexCatalog) {
+		if (strcmp(index.relName, relName) != 0)
+			continue;
+		getRecord(record, index.catalogRecId.block, index.catalogRecId.slot);
+		for (int attr = 0; attr < index.numAttrs; attr++) {
+			if (strcmp(record[INDEXCAT_ATTR_NAME_INDEX + attr].sval, oldName) == 0)
+				strcpy(record[INDEXCAT_ATTR_NAME_INDEX + attr].sval, newName);
+		}
+		setRecord(record, index.catalogRecId.block, index.catalogRecId.slot);
+	}
+	invalidateIndexCatalog();
+	return SUCCESS;
+}
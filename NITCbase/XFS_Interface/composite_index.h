@@ -0,0 +1,36 @@
+#ifndef NITCBASE_COMPOSITE_INDEX_H
+#define NITCBASE_COMPOSITE_INDEX_H
+
+#include <vector>
+#include "define/constants.h"
+#include "disk_structures.h"
+
+/*
+ * An entry of the Index Catalog: a B+ tree over the values of an ordered list of attributes of a relation,
+ * keyed by encodeCompositeKey. attrOffsets and attrTypes are only filled in by getCompositeIndexes.
+ */
+typedef struct CompositeIndex {
+	char relName[ATTR_SIZE];
+	int numAttrs;
+	char attrNames[COMPOSITE_INDEX_MAX_ATTRS][ATTR_SIZE];
+	int attrOffsets[COMPOSITE_INDEX_MAX_ATTRS];
+	int attrTypes[COMPOSITE_INDEX_MAX_ATTRS];
+	int rootBlock;
+	recId catalogRecId;
+} CompositeIndex;
+
+int encodeCompositeKey(const Attribute *values, const int *types, int numValues, unsigned char pad, Attribute *key);
+
+int createCompositeIndex(int relId, int numAttrs, char attrNames[][ATTR_SIZE]);
+int dropCompositeIndex(int relId, int numAttrs, char attrNames[][ATTR_SIZE]);
+int getCompositeIndexes(int relId, std::vector<CompositeIndex> &indexes);
+int insertIntoCompositeIndexes(int relId, Attribute *record, recId recordId);
+int insertEntriesIntoCompositeIndex(const CompositeIndex &index, Index *entries, int numEntries, int numExisting);
+int deleteFromCompositeIndexes(int relId, Attribute *record, recId recordId);
+int updateCompositeIndexes(int relId, Attribute *oldRecord, Attribute *newRecord, recId recordId);
+int deleteCompositeIndexes(char relName[ATTR_SIZE]);
+int renameCompositeIndexRelation(char oldName[ATTR_SIZE], char newName[ATTR_SIZE]);
+int renameCompositeIndexAttribute(char relName[ATTR_SIZE], char oldName[ATTR_SIZE], char newName[ATTR_SIZE]);
+void invalidateIndexCatalog();
+
+#endif //NITCBASE_COMPOSITE_INDEX_H
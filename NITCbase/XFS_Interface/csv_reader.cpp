@@ -0,0 +1,119 @@
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "define/constants.h"
+#include "csv_reader.h"
+
+CSVReader::CSVReader() {
+	file = nullptr;
+	buffer = nullptr;
+	capacity = 0;
+	begin = end = 0;
+	endOfFile = true;
+}
+
+CSVReader::~CSVReader() {
+	if (file != nullptr)
+		fclose(file);
+	free(buffer);
+}
+
+int CSVReader::open(const char *fileName) {
+	file = fopen(fileName, "r");
+	if (file == nullptr)
+		return FAILURE;
+	capacity = CSV_READ_BUFFER_SIZE;
+	buffer = (char *) malloc(capacity + 1);
+	begin = end = 0;
+	endOfFile = false;
+	return SUCCESS;
+}
+
+/*
+ * Moves the unread bytes to the front of the buffer and reads the file after them, doubling the buffer when a
+ * single line fills all of it. Returns false once nothing more can be read.
+ */
+bool CSVReader::fill() {
+	if (endOfFile)
+		return false;
+	if (begin > 0) {
+		memmove(buffer, buffer + begin, end - begin);
+		end -= begin;
+		begin = 0;
+	}
+	if (end == capacity) {
+		capacity *= 2;
+		buffer = (char *) realloc(buffer, capacity + 1);
+	}
+	size_t bytesRead = fread(buffer + end, 1, capacity - end, file);
+	if (bytesRead == 0) {
+		endOfFile = true;
+		return false;
+	}
+	end += bytesRead;
+	return true;
+}
+
+/*
+ * Reads the next line of the file into *line, '\0' terminated. With skipBlanks, the spaces, tabs and empty lines
+ * before the line are skipped.
+ * @return : length of the line, or FAILURE at the end of the file
+ */
+int CSVReader::readLine(char **line, bool skipBlanks) {
+	while (true) {
+		if (skipBlanks) {
+			while (begin < end && (buffer[begin] == ' ' || buffer[begin] == '\t' || buffer[begin] == '\n'))
+				begin++;
+			if (begin == end) {
+				if (!fill())
+					return FAILURE;
+				continue;
+			}
+		}
+
+		char *newline = (char *) memchr(buffer + begin, '\n', end - begin);
+		if (newline != nullptr) {
+			*newline = '\0';
+			*line = buffer + begin;
+			int length = newline - *line;
+			begin += length + 1;
+			return length;
+		}
+		if (!fill()) {
+			// the last line of the file need not end with '\n'
+			if (begin == end)
+				return FAILURE;
+			buffer[end] = '\0';
+			*line = buffer + begin;
+			int length = end - begin;
+			begin = end;
+			return length;
+		}
+	}
+}
+
+/*
+ * Splits a line at its commas into fields, keeping the first ATTR_SIZE - 1 characters of each field. Only the
+ * first maxFields fields are copied, but all of them are counted.
+ * @return : number of fields in the line, or FAILURE if a field is empty
+ */
+int splitCSVLine(char *line, int length, int maxFields, char fields[][ATTR_SIZE]) {
+	char *lineEnd = line + length;
+	char *position = line;
+	int numFields = 0;
+	while (true) {
+		char *comma = (char *) memchr(position, ',', lineEnd - position);
+		char *fieldEnd = (comma != nullptr) ? comma : lineEnd;
+		if (fieldEnd == position)
+			return FAILURE;
+		if (numFields < maxFields) {
+			int fieldLength = std::min((int) (fieldEnd - position), ATTR_SIZE - 1);
+			memcpy(fields[numFields], position, fieldLength);
+			fields[numFields][fieldLength] = '\0';
+		}
+		numFields++;
+		if (comma == nullptr)
+			return numFields;
+		position = comma + 1;
+	}
+}
@@ -0,0 +1,31 @@
+#ifndef NITCBASE_CSV_READER_H
+#define NITCBASE_CSV_READER_H
+
+#include <cstdio>
+#include "define/constants.h"
+
+/*
+ * Reads the lines of a CSV file one after another. The file is read in blocks of CSV_READ_BUFFER_SIZE bytes and
+ * the end of a line is found with memchr, so no call is made and nothing is allocated per character; the buffer
+ * only grows for a line longer than itself. A line is handed out in place in the buffer, without its '\n', and
+ * stays valid until the next call to readLine.
+ */
+class CSVReader {
+private:
+	FILE *file;
+	char *buffer;
+	int capacity;
+	int begin;
+	int end;
+	bool endOfFile;
+	bool fill();
+public:
+	CSVReader();
+	~CSVReader();
+	int open(const char *fileName);
+	int readLine(char **line, bool skipBlanks);
+};
+
+int splitCSVLine(char *line, int length, int maxFields, char fields[][ATTR_SIZE]);
+
+#endif //NITCBASE_CSV_READER_H
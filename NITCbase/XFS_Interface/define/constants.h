@@ -47,6 +47,19 @@
 #define MAX_OPEN 12
 // Number of blocks given for Block Allocation Map in the disk
 #define BLOCK_ALLOCATION_MAP_SIZE 4
+// Size in bytes of build side records a hash join keeps in memory before it partitions its inputs
+#define JOIN_MEMORY_SIZE (256 * 1024)
+// Maximum number of partitions a hash join splits an input into in one pass, all of which are open while it does.
+// A partition whose build side is still larger than JOIN_MEMORY_SIZE is split again.
+#define JOIN_MAX_PARTITIONS 4
+// Size in bytes of records an external sort keeps in memory to build each sorted run
+#define SORT_MEMORY_SIZE (256 * 1024)
+// Maximum number of sorted runs an external sort merges at once
+#define SORT_MERGE_FANIN 4
+// Size in bytes of records a bulk insert parses before it writes them into record blocks
+#define INSERT_BATCH_SIZE (256 * 1024)
+// Size in bytes of the blocks a CSV file is read in by import and INSERT ... VALUES FROM
+#define CSV_READ_BUFFER_SIZE (1024 * 1024)
 
 // Number of attributes present in one entry / record of the Relation Catalog
 #define RELCAT_NO_ATTRS 6
@@ -109,11 +122,24 @@
 // project operator used for project operation
 #define PRJCT 107
 
+// Sort orders
+// Ascending
+#define ASC 0
+// Descending
+#define DESC 1
+
 // Data types
 // For an Integer or a Floating point number
 #define NUMBER 0
 // For a string of characters
 #define STRING 1
+// For the keys of a composite index, the values of its attributes encoded into bytes compared with memcmp
+#define COMPOSITE 2
+
+// Maximum number of attributes a composite index can be built on. A composite key holds only the first ATTR_SIZE
+// bytes of the encoded values (8 for a NUMBER, the characters and a NUL for a STRING), so a composite index is a
+// prefix index: two NUMBERs fit whole, while a STRING leaves less, or nothing, of the attribute after it
+#define COMPOSITE_INDEX_MAX_ATTRS 2
 
 // Relid for Relation catalog
 #define RELCAT_RELID 0
@@ -130,6 +156,14 @@
 
 // Used for internal purposes
 #define TEMP "temp"
+// Prefixes of the temporary relations of joins and sorts. They contain '#', which the relation names given in
+// commands and imported file names cannot, so they never collide with a relation of the user.
+// Prefix of the temporary relations holding the partitions of a hash join
+#define JOIN_PARTITION_PREFIX "temp#"
+// Prefix of the temporary relations holding the sorted runs of an external sort
+#define SORT_RUN_PREFIX "temp#r"
+// Name the unsorted relation is kept under while ORDER BY replaces it by the sorted one
+#define SORT_UNSORTED_RELNAME "temp#u"
 
 // Indexes for Relation Catalog Attributes
 // Index for the Relation Name attribute of a relation catalog entry
@@ -159,6 +193,18 @@
 // Index for Offset attribute of an attribute catalog entry
 #define ATTRCAT_OFFSET_INDEX 5
 
+// Indexes for Index Catalog Attributes
+// Index for the Relation Name attribute of an index catalog entry
+#define INDEXCAT_REL_NAME_INDEX 0
+// Index for the #Attributes attribute of an index catalog entry
+#define INDEXCAT_NO_ATTRIBUTES_INDEX 1
+// Index for the Root Block attribute of an index catalog entry
+#define INDEXCAT_ROOT_BLOCK_INDEX 2
+// Index for the first of the COMPOSITE_INDEX_MAX_ATTRS Attribute Name attributes of an index catalog entry
+#define INDEXCAT_ATTR_NAME_INDEX 3
+// Number of attributes present in one entry / record of the Index Catalog
+#define INDEXCAT_NO_ATTRS (INDEXCAT_ATTR_NAME_INDEX + COMPOSITE_INDEX_MAX_ATTRS)
+
 // Global variables for B+ Tree Layer
 // Maximum number of keys allowed in an Internal Node of a B+ tree
 #define MAX_KEYS_INTERNAL 100
@@ -168,10 +214,22 @@
 #define MAX_KEYS_LEAF 63
 // Index of the middle element in a Leaf Node of a B+ tree
 #define MIDDLE_INDEX_LEAF 31
+// Minimum number of keys in a non-root Internal Node before a delete borrows from or merges with a sibling
+#define MIN_KEYS_INTERNAL MIDDLE_INDEX_INTERNAL
+// Minimum number of keys in a non-root Leaf Node before a delete borrows from or merges with a sibling
+#define MIN_KEYS_LEAF MIDDLE_INDEX_LEAF
+// Percentage of the maximum number of keys a bulk load puts in each node of a B+ tree
+#define INDEX_FILL_FACTOR 90
+// A batch of entries at least 1/INDEX_REBUILD_RATIO the size of a B+ tree is merged with its entries into a new
+// bulk loaded tree, instead of being inserted into it one by one
+#define INDEX_REBUILD_RATIO 16
 
 // Name strings for Relation Catalog and Attribute Catalog (as it is stored in the Relation catalog)
 #define RELCAT_RELNAME "RELATIONCAT"
 #define ATTRCAT_RELNAME "ATTRIBUTECAT"
+// Name of the Index Catalog, the relation listing the composite indexes, created with the first of them.
+// Like the temporary relations, it contains '#', so no relation of the user can take its name.
+#define INDEXCAT_RELNAME "INDEXCAT#"
 
 // Relation Catalog attribute name strings
 #define RELCAT_ATTR_RELNAME "RelName"
@@ -189,4 +247,10 @@
 #define ATTRCAT_ATTR_ROOT_BLOCK "RootBlock"
 #define ATTRCAT_ATTR_OFFSET "Offset"
 
+// Index Catalog attribute name strings (the attribute names are followed by their position, from 1)
+#define INDEXCAT_ATTR_RELNAME "RelName"
+#define INDEXCAT_ATTR_NO_ATTRIBUTES "#Attributes"
+#define INDEXCAT_ATTR_ROOT_BLOCK "RootBlock"
+#define INDEXCAT_ATTR_ATTRIBUTE_NAME "AttributeName"
+
 #endif  // NITCBASE_CONSTANTS_H
\ No newline at end of file
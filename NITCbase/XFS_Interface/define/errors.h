@@ -58,4 +58,7 @@
 // Error: Cannot rename a relation to 'temp'
 #define E_RENAMETOTEMP -26
 
+// Error: Index already exists
+#define E_INDEXEXISTS -27
+
 #endif  // NITCBASE_ERRORS_H
\ No newline at end of file
@@ -63,6 +63,19 @@ typedef union Attribute {
 	char sval[ATTR_SIZE];
 } Attribute;
 
+/*
+ * All occupied records of a record block, decoded with a single read of the block.
+ * The i-th occupied record lives in slot slotNums[i] and its attributes are
+ * records[i * header.numAttrs] to records[(i + 1) * header.numAttrs - 1].
+ */
+typedef struct RecordBatch {
+	HeadInfo header;
+	int numRecords;
+	unsigned char slotMap[BLOCK_SIZE - HEADER_SIZE];
+	int slotNums[BLOCK_SIZE - HEADER_SIZE];
+	union Attribute records[(BLOCK_SIZE - HEADER_SIZE) / ATTR_SIZE];
+} RecordBatch;
+
 typedef struct InternalEntry {
 	int32_t lChild;
 	union Attribute attrVal;
@@ -1,12 +1,15 @@
 #include <iostream>
 #include <cstdio>
 #include <cstring>
+#include <vector>
+#include <algorithm>
 #include "external_fs_commands.h"
 #include "disk_structures.h"
 #include "block_access.h"
 #include "OpenRelTable.h"
 #include "algebra.h"
 #include "schema.h"
+#include "csv_reader.h"
 
 using namespace std;
 
@@ -177,104 +180,73 @@ void ls() {
 	std::cout << "\n";
 }
 
+/*
+ * Creates a relation named after the CSV file and inserts the records of the file into it. The first line of the
+ * file holds the attribute names, and the attribute types are inferred from the first record. The file is read
+ * through a CSVReader and the records are written with one bulk insert in batches of about INSERT_BATCH_SIZE
+ * bytes; the relation is deleted again if any line of the file is rejected.
+ */
 int importRelation(char *fileName) {
 
-	FILE *file = fopen(fileName, "r");
+	CSVReader reader;
+	if (reader.open(fileName) != SUCCESS)
+		return FAILURE;
 
 	/*
 	 *  GET ATTRIBUTE NAMES FROM FIRST LINE OF FILE
 	 */
-	char *firstLine = (char *) malloc(sizeof(char));
-	int numOfCharactersInLine = 1;
-	int currentCharacter, previousCharacter;
-	int numOfAttributes = 1;
-	previousCharacter = ',';
-	while ((currentCharacter = fgetc(file)) != '\n') {
-		if (currentCharacter == EOF)
-			break;
-		while (currentCharacter == ' ' || currentCharacter == '\t' || currentCharacter == '\n') {
-			currentCharacter = fgetc(file);
-		}
-		if (currentCharacter == EOF)
-			break;
-		if (currentCharacter == ',') {
-			numOfAttributes++;
-			if (previousCharacter == currentCharacter) {
-				cout << "Null values are not allowed in attribute names\n";
-				return FAILURE;
-			}
-		}
-		firstLine[numOfCharactersInLine - 1] = currentCharacter;
-		numOfCharactersInLine++;
-		firstLine = (char *) realloc(firstLine, (numOfCharactersInLine) * sizeof(char));
-		previousCharacter = currentCharacter;
+	char *line;
+	int lineLength = reader.readLine(&line, false);
+	if (lineLength == FAILURE) {
+		cout << "The file is empty\n";
+		return FAILURE;
+	}
+	int numOfCharactersInLine = 0;
+	for (int charIndex = 0; charIndex < lineLength; charIndex++) {
+		if (line[charIndex] != ' ' && line[charIndex] != '\t')
+			line[numOfCharactersInLine++] = line[charIndex];
 	}
+	line[numOfCharactersInLine] = '\0';
 
-	if (previousCharacter == ',') {
+	int numOfAttributes = splitCSVLine(line, numOfCharactersInLine, 0, nullptr);
+	if (numOfAttributes == FAILURE) {
 		cout << "Null values are not allowed in attribute names\n";
 		return FAILURE;
 	}
 
-    if (numOfAttributes > 125) {
-        return E_MAXATTRS;
-    }
+	if (numOfAttributes > 125) {
+		return E_MAXATTRS;
+	}
 
-	firstLine[numOfCharactersInLine - 1] = '\0';
-	int currentCharIndexInLine = 0, attrOffsetIterator, attributeIndexIterator;
 	char attributeNames[numOfAttributes][ATTR_SIZE];
-	attrOffsetIterator = 0;
-	while (attrOffsetIterator < numOfAttributes) {
-		attributeIndexIterator = 0;
-		while (((firstLine[currentCharIndexInLine] != ',') && (firstLine[currentCharIndexInLine] != '\0')) &&
-		       (attributeIndexIterator < ATTR_SIZE - 1)) {
-			if (checkIfInvalidCharacter(firstLine[currentCharIndexInLine])) {
-				cout << "Invalid character : '" << firstLine[currentCharIndexInLine] << "' in attribute name\n";
+	splitCSVLine(line, numOfCharactersInLine, numOfAttributes, attributeNames);
+	for (int attrOffset = 0; attrOffset < numOfAttributes; attrOffset++) {
+		for (char *character = attributeNames[attrOffset]; *character != '\0'; character++) {
+			if (checkIfInvalidCharacter(*character)) {
+				cout << "Invalid character : '" << *character << "' in attribute name\n";
 				return FAILURE;
 			}
-			attributeNames[attrOffsetIterator][attributeIndexIterator++] = firstLine[currentCharIndexInLine++];
-		}
-		if (attributeIndexIterator == ATTR_SIZE - 1) {
-			while (firstLine[currentCharIndexInLine] != ',')
-				currentCharIndexInLine++;
 		}
-		attributeNames[attrOffsetIterator][attributeIndexIterator] = '\0';
-		attrOffsetIterator++;
-		currentCharIndexInLine++;
 	}
-	currentCharIndexInLine = 0;
 
 	/*
-	 *  INFER ATTRIBUTE TYPES FROM SECOND LINE OF FILE
+	 *  INFER ATTRIBUTE TYPES FROM FIRST RECORD OF FILE
 	 */
-	char *secondLine = (char *) malloc(sizeof(char));
-	numOfCharactersInLine = 1;
-	while ((currentCharacter = fgetc(file)) != '\n') {
-		if (currentCharacter == EOF)
-			break;
-		secondLine[numOfCharactersInLine - 1] = currentCharacter;
-		numOfCharactersInLine++;
-		secondLine = (char *) realloc(secondLine, (numOfCharactersInLine) * sizeof(char));
-	}
-	secondLine[numOfCharactersInLine - 1] = '\0';
-	currentCharIndexInLine = 0;
-	char secondLineFields[numOfAttributes][ATTR_SIZE];
+	char attributesCharArray[numOfAttributes][ATTR_SIZE];
 	int attrTypes[numOfAttributes];
-	attrOffsetIterator = 0;
-	while (attrOffsetIterator < numOfAttributes) {
-		attributeIndexIterator = 0;
-		while (((secondLine[currentCharIndexInLine] != ',') && (secondLine[currentCharIndexInLine] != '\0')) &&
-		       (attributeIndexIterator < ATTR_SIZE - 1)) {
-			secondLineFields[attrOffsetIterator][attributeIndexIterator++] = secondLine[currentCharIndexInLine++];
-		}
-		secondLineFields[attrOffsetIterator][attributeIndexIterator] = '\0';
-		attrTypes[attrOffsetIterator] = checkAttrTypeOfValue(secondLineFields[attrOffsetIterator]);
-
-		attrOffsetIterator++;
-		currentCharIndexInLine++;
+	lineLength = reader.readLine(&line, true);
+	int numOfFieldsInLine = FAILURE;
+	if (lineLength != FAILURE)
+		numOfFieldsInLine = splitCSVLine(line, lineLength, numOfAttributes, attributesCharArray);
+	for (int attrOffset = 0; attrOffset < numOfAttributes; attrOffset++) {
+		// a malformed first record is reported once the relation exists, like any other line
+		if (numOfFieldsInLine == numOfAttributes)
+			attrTypes[attrOffset] = checkAttrTypeOfValue(attributesCharArray[attrOffset]);
+		else
+			attrTypes[attrOffset] = STRING;
 	}
 
 	// EXTRACT RELATION NAME FROM FILE PATH
-	currentCharIndexInLine = 0;
 	char relationName[ATTR_SIZE];
 	int fileNameIterator = strlen(fileName) - 1;
 	while (fileName[fileNameIterator] != '.') {
@@ -315,117 +287,62 @@ int importRelation(char *fileName) {
 		return FAILURE;
 	}
 
-	// Skip first line containing attribute names
-	file = fopen(fileName, "r");
-	while ((currentCharacter = fgetc(file)) != '\n')
-		continue;
-
-	char *currentLineAsCharArray = (char *) malloc(sizeof(char));
-	numOfCharactersInLine = 1;
+	BulkInsert bulk;
+	int retValue = ba_beginBulkInsert(relId, &bulk);
+	int batchCapacity = std::max(1, INSERT_BATCH_SIZE / (numOfAttributes * ATTR_SIZE));
+	std::vector<Attribute> batch(batchCapacity * numOfAttributes);
+	int numOfRecordsInBatch = 0;
 
 	int lineNumber = 2;
-	while (true) {
-		currentCharacter = fgetc(file);
-		if (currentCharacter == EOF)
-			break;
-		while (currentCharacter == ' ' || currentCharacter == '\t' || currentCharacter == '\n') {
-			currentCharacter = fgetc(file);
-		}
-		if (currentCharacter == EOF)
-			break;
-		numOfCharactersInLine = 1;
-		int numOfFieldsInLine = 0;
-		previousCharacter = ',';
-
-
-		while ((currentCharacter != '\n') && (currentCharacter != EOF)) {
-
-			if (currentCharacter == ',')
-				numOfFieldsInLine++;
-			if (currentCharacter == previousCharacter && currentCharacter == ',') {
-				OpenRelTable::closeRelation(relId);
-				ba_delete(relationName);
-				cout << "Null values are not allowed in attribute fields\n";
-				return FAILURE;
-			}
-			currentLineAsCharArray[numOfCharactersInLine - 1] = currentCharacter;
-			numOfCharactersInLine++;
-			currentLineAsCharArray = (char *) realloc(currentLineAsCharArray, (numOfCharactersInLine) * sizeof(char));
-			previousCharacter = currentCharacter;
-
-			currentCharacter = fgetc(file);
-
-		}
-
-		if (previousCharacter == ',') {
-			OpenRelTable::closeRelation(relId);
-			ba_delete(relationName);
-
+	while (retValue == SUCCESS && lineLength != FAILURE) {
+		numOfFieldsInLine = splitCSVLine(line, lineLength, numOfAttributes, attributesCharArray);
+		if (numOfFieldsInLine == FAILURE) {
 			cout << "Null values are not allowed in attribute fields\n";
-			return FAILURE;
+			retValue = FAILURE;
+			break;
 		}
-		if (numOfAttributes != numOfFieldsInLine + 1) {
-			OpenRelTable::closeRelation(relId);
-			ba_delete(relationName);
-
+		if (numOfFieldsInLine != numOfAttributes) {
 			cout << "Mismatch in number of attributes\n";
-			return FAILURE;
-		}
-		currentLineAsCharArray[numOfCharactersInLine - 1] = '\0';
-		currentCharIndexInLine = 0;
-
-		char attributesCharArray[numOfAttributes][ATTR_SIZE];
-		attrOffsetIterator = 0;
-		while (attrOffsetIterator < numOfAttributes) {
-			attributeIndexIterator = 0;
-
-			while (((currentLineAsCharArray[currentCharIndexInLine] != ',') &&
-			        (currentLineAsCharArray[currentCharIndexInLine] != '\0')) &&
-			       (attributeIndexIterator < ATTR_SIZE - 1)) {
-				attributesCharArray[attrOffsetIterator][attributeIndexIterator++] = currentLineAsCharArray[currentCharIndexInLine++];
-			}
-			if (attributeIndexIterator == ATTR_SIZE - 1) {
-				while (currentLineAsCharArray[currentCharIndexInLine] != ',')
-					currentCharIndexInLine++;
-			}
-			currentCharIndexInLine++;
-			attributesCharArray[attrOffsetIterator][attributeIndexIterator] = '\0';
-
-			attrOffsetIterator++;
+			retValue = FAILURE;
+			break;
 		}
 
-		Attribute record[numOfAttributes];
-		int retValue = constructRecordFromAttrsArray(numOfAttributes, record, attributesCharArray, attrTypes);
-
-		if (retValue == E_ATTRTYPEMISMATCH) {
-			OpenRelTable::closeRelation(relId);
-			ba_delete(relationName);
-
-			return E_ATTRTYPEMISMATCH;
-		} else if (retValue == E_INVALID) {
-			OpenRelTable::closeRelation(relId);
-			ba_delete(relationName);
-
+		Attribute *record = &batch[numOfRecordsInBatch * numOfAttributes];
+		retValue = constructRecordFromAttrsArray(numOfAttributes, record, attributesCharArray, attrTypes);
+		if (retValue == E_INVALID) {
 			cout << "Invalid character at line " << lineNumber << " in file \n";
-			return FAILURE;
+			retValue = FAILURE;
+			break;
+		} else if (retValue != SUCCESS) {
+			break;
 		}
 
-		int retVal = ba_insert(relId, record);
-
-		if (retVal != SUCCESS) {
-			OpenRelTable::closeRelation(relId);
-			ba_delete(relationName);
-
-			cout << "Insert failed at line"<< lineNumber << " in file"  << endl;
-			return retVal;
+		numOfRecordsInBatch++;
+		if (numOfRecordsInBatch == batchCapacity) {
+			retValue = ba_bulkInsert(&bulk, batch.data(), numOfRecordsInBatch);
+			numOfRecordsInBatch = 0;
+			if (retValue != SUCCESS) {
+				cout << "Insert failed at line " << lineNumber << " in file" << endl;
+				break;
+			}
 		}
-		if (currentCharacter == EOF)
-			break;
 
+		lineLength = reader.readLine(&line, true);
 		lineNumber++;
 	}
+	if (retValue == SUCCESS && numOfRecordsInBatch > 0) {
+		retValue = ba_bulkInsert(&bulk, batch.data(), numOfRecordsInBatch);
+		if (retValue != SUCCESS)
+			cout << "Insert failed at line " << lineNumber - 1 << " in file" << endl;
+	}
+	if (retValue == SUCCESS)
+		retValue = ba_endBulkInsert(&bulk);
+
 	OpenRelTable::closeRelation(relId);
-	fclose(file);
+	if (retValue != SUCCESS) {
+		ba_delete(relationName);
+		return retValue;
+	}
 	return SUCCESS;
 }
 
@@ -34,6 +34,8 @@ bool checkValidCsvFile(string filename);
 
 int getOperator(string op_str);
 
+void extract_conditions(string conditions_str, vector<string> &attributes, vector<int> &ops, vector<string> &values);
+
 int printSchema(char relname[ATTR_SIZE]);
 
 int printRows(char relname[ATTR_SIZE]);
@@ -54,6 +56,15 @@ int select_attr_from_join_handler(char sourceRelOneName[ATTR_SIZE], char sourceR
                                   char joinAttributeOne[ATTR_SIZE], char joinAttributeTwo[ATTR_SIZE],
                                   char attributeList[][ATTR_SIZE]);
 
+int select_from_where_and_handler(char sourceRelName[ATTR_SIZE], char targetRelName[ATTR_SIZE], int cond_count,
+                                  char attributes[][ATTR_SIZE], int ops[], char values[][ATTR_SIZE]);
+
+int select_attr_from_where_and_handler(char sourceRelName[ATTR_SIZE], char targetRelName[ATTR_SIZE], int attr_count,
+                                       char attrs[][ATTR_SIZE], int cond_count, char attributes[][ATTR_SIZE], int ops[],
+                                       char values[][ATTR_SIZE]);
+
+int order_by_handler(char relName[ATTR_SIZE], char attribute[ATTR_SIZE], int order);
+
 void print16(char char_string_thing[ATTR_SIZE]);
 
 void print16(char char_string_thing[ATTR_SIZE], bool newline);
@@ -360,6 +371,47 @@ int regexMatchAndExecute(const string input_command) {
 			printErrorMsg(ret);
 			return FAILURE;
 		}
+	} else if (regex_match(input_command, create_composite_index)) {
+		regex_search(input_command, m, create_composite_index);
+		string tablename = m[1];
+		char relname[ATTR_SIZE];
+		string_to_char_array(tablename, relname, ATTR_SIZE - 1);
+
+		vector<string> attr_tokens = extract_tokens(m[2]);
+		int attr_count = attr_tokens.size();
+		char attr_list[attr_count][ATTR_SIZE];
+		for (int attr_no = 0; attr_no < attr_count; attr_no++) {
+			string_to_char_array(attr_tokens[attr_no], attr_list[attr_no], ATTR_SIZE - 1);
+		}
+
+		int ret = createIndex(relname, attr_count, attr_list);
+		if (ret > 0)
+			cout << "Index created successfully\n";
+		else {
+			printErrorMsg(ret);
+			return FAILURE;
+		}
+
+	} else if (regex_match(input_command, drop_composite_index)) {
+		regex_search(input_command, m, drop_composite_index);
+		string tablename = m[1];
+		char relname[ATTR_SIZE];
+		string_to_char_array(tablename, relname, ATTR_SIZE - 1);
+
+		vector<string> attr_tokens = extract_tokens(m[2]);
+		int attr_count = attr_tokens.size();
+		char attr_list[attr_count][ATTR_SIZE];
+		for (int attr_no = 0; attr_no < attr_count; attr_no++) {
+			string_to_char_array(attr_tokens[attr_no], attr_list[attr_no], ATTR_SIZE - 1);
+		}
+
+		int ret = dropIndex(relname, attr_count, attr_list);
+		if (ret == SUCCESS)
+			cout << "Index deleted successfully\n";
+		else {
+			printErrorMsg(ret);
+			return FAILURE;
+		}
 	} else if (regex_match(input_command, rename_table)) {
 
 		regex_search(input_command, m, rename_table);
@@ -450,6 +502,76 @@ int regexMatchAndExecute(const string input_command) {
 			return FAILURE;
 		}
 
+	} else if (regex_match(input_command, delete_from)) {
+		regex_search(input_command, m, delete_from);
+		string rel_str = m[1];
+		char relName[ATTR_SIZE];
+		string_to_char_array(rel_str, relName, ATTR_SIZE - 1);
+
+		// without a WHERE clause, every record is deleted
+		vector<string> attribute_tokens, value_tokens;
+		vector<int> ops;
+		extract_conditions(m[2], attribute_tokens, ops, value_tokens);
+
+		int cond_count = ops.size();
+		char attributes[cond_count + 1][ATTR_SIZE];
+		char values[cond_count + 1][ATTR_SIZE];
+		for (int cond_no = 0; cond_no < cond_count; cond_no++) {
+			string_to_char_array(attribute_tokens[cond_no], attributes[cond_no], ATTR_SIZE - 1);
+			string_to_char_array(value_tokens[cond_no], values[cond_no], ATTR_SIZE - 1);
+		}
+
+		int numDeleted;
+		int retValue = deleteRecords(relName, cond_count, attributes, ops.data(), values, &numDeleted);
+		if (retValue == SUCCESS) {
+			cout << "Deleted " << numDeleted << " record(s)" << endl;
+		} else {
+			printErrorMsg(retValue);
+			cout << "Deleted " << numDeleted << " record(s) before the error" << endl;
+			return FAILURE;
+		}
+
+	} else if (regex_match(input_command, update_set)) {
+		regex_search(input_command, m, update_set);
+		string rel_str = m[1];
+		char relName[ATTR_SIZE];
+		string_to_char_array(rel_str, relName, ATTR_SIZE - 1);
+
+		// the assignments of the SET clause are split the same way as conditions with '='
+		vector<string> set_attribute_tokens, set_value_tokens;
+		vector<int> set_ops;
+		extract_conditions(m[2], set_attribute_tokens, set_ops, set_value_tokens);
+
+		int set_count = set_ops.size();
+		char set_attributes[set_count][ATTR_SIZE];
+		char set_values[set_count][ATTR_SIZE];
+		for (int set_no = 0; set_no < set_count; set_no++) {
+			string_to_char_array(set_attribute_tokens[set_no], set_attributes[set_no], ATTR_SIZE - 1);
+			string_to_char_array(set_value_tokens[set_no], set_values[set_no], ATTR_SIZE - 1);
+		}
+
+		// without a WHERE clause, every record is updated
+		vector<string> attribute_tokens, value_tokens;
+		vector<int> ops;
+		extract_conditions(m[3], attribute_tokens, ops, value_tokens);
+
+		int cond_count = ops.size();
+		char attributes[cond_count + 1][ATTR_SIZE];
+		char values[cond_count + 1][ATTR_SIZE];
+		for (int cond_no = 0; cond_no < cond_count; cond_no++) {
+			string_to_char_array(attribute_tokens[cond_no], attributes[cond_no], ATTR_SIZE - 1);
+			string_to_char_array(value_tokens[cond_no], values[cond_no], ATTR_SIZE - 1);
+		}
+
+		int retValue = updateRecords(relName, set_count, set_attributes, set_values, cond_count, attributes,
+		                             ops.data(), values);
+		if (retValue >= 0) {
+			cout << "Updated " << retValue << " record(s)" << endl;
+		} else {
+			printErrorMsg(retValue);
+			return FAILURE;
+		}
+
 	} else if (regex_match(input_command, select_from)) {
 		regex_search(input_command, m, select_from);
 		string sourceRelName_str = m[1];
@@ -558,6 +680,72 @@ int regexMatchAndExecute(const string input_command) {
 		return select_attr_from_where_handler(sourceRelName, targetRelName, attr_count, attr_list, attribute, op,
 		                                      value);
 
+	} else if (regex_match(input_command, select_from_where_and)) {
+		regex_search(input_command, m, select_from_where_and);
+		string sourceRel_str = m[1];
+		string targetRel_str = m[2];
+
+		if (targetRel_str == TEMP) {
+			printErrorMsg(E_TARGETNAMETEMP);
+			return FAILURE;
+		}
+
+		char sourceRelName[ATTR_SIZE];
+		char targetRelName[ATTR_SIZE];
+		string_to_char_array(sourceRel_str, sourceRelName, ATTR_SIZE - 1);
+		string_to_char_array(targetRel_str, targetRelName, ATTR_SIZE - 1);
+
+		vector<string> attribute_tokens, value_tokens;
+		vector<int> ops;
+		extract_conditions(m[3], attribute_tokens, ops, value_tokens);
+
+		int cond_count = ops.size();
+		char attributes[cond_count][ATTR_SIZE];
+		char values[cond_count][ATTR_SIZE];
+		for (int cond_no = 0; cond_no < cond_count; cond_no++) {
+			string_to_char_array(attribute_tokens[cond_no], attributes[cond_no], ATTR_SIZE - 1);
+			string_to_char_array(value_tokens[cond_no], values[cond_no], ATTR_SIZE - 1);
+		}
+
+		return select_from_where_and_handler(sourceRelName, targetRelName, cond_count, attributes, ops.data(), values);
+
+	} else if (regex_match(input_command, select_attr_from_where_and)) {
+		regex_search(input_command, m, select_attr_from_where_and);
+		string sourceRel_str = m[2];
+		string targetRel_str = m[3];
+
+		if (targetRel_str == TEMP) {
+			printErrorMsg(E_TARGETNAMETEMP);
+			return FAILURE;
+		}
+
+		char sourceRelName[ATTR_SIZE];
+		char targetRelName[ATTR_SIZE];
+		string_to_char_array(sourceRel_str, sourceRelName, ATTR_SIZE - 1);
+		string_to_char_array(targetRel_str, targetRelName, ATTR_SIZE - 1);
+
+		vector<string> attr_tokens = extract_tokens(m[1]);
+		int attr_count = attr_tokens.size();
+		char attr_list[attr_count][ATTR_SIZE];
+		for (int attr_no = 0; attr_no < attr_count; attr_no++) {
+			string_to_char_array(attr_tokens[attr_no], attr_list[attr_no], ATTR_SIZE - 1);
+		}
+
+		vector<string> attribute_tokens, value_tokens;
+		vector<int> ops;
+		extract_conditions(m[4], attribute_tokens, ops, value_tokens);
+
+		int cond_count = ops.size();
+		char attributes[cond_count][ATTR_SIZE];
+		char values[cond_count][ATTR_SIZE];
+		for (int cond_no = 0; cond_no < cond_count; cond_no++) {
+			string_to_char_array(attribute_tokens[cond_no], attributes[cond_no], ATTR_SIZE - 1);
+			string_to_char_array(value_tokens[cond_no], values[cond_no], ATTR_SIZE - 1);
+		}
+
+		return select_attr_from_where_and_handler(sourceRelName, targetRelName, attr_count, attr_list, cond_count,
+		                                          attributes, ops.data(), values);
+
 	} else if (regex_match(input_command, select_from_join)) {
 
 		regex_search(input_command, m, select_from_join);
@@ -638,6 +826,29 @@ int regexMatchAndExecute(const string input_command) {
 		return select_attr_from_join_handler(sourceRelOneName, sourceRelTwoName, targetRelName, attrCount,
 		                                     joinAttributeOne, joinAttributeTwo, attributeList);
 
+	} else if (regex_match(input_command, select_order_by)) {
+		regex_search(input_command, m, select_order_by);
+		string select_str = string(m[1]) + string(m[2]) + string(m[3]);
+		string targetRel_str = m[2];
+		string attribute_str = m[4];
+		string order_str = m[5];
+
+		if (targetRel_str == TEMP) {
+			printErrorMsg(E_TARGETNAMETEMP);
+			return FAILURE;
+		}
+
+		char targetRelName[ATTR_SIZE];
+		char attribute[ATTR_SIZE];
+		string_to_char_array(targetRel_str, targetRelName, ATTR_SIZE - 1);
+		string_to_char_array(attribute_str, attribute, ATTR_SIZE - 1);
+		int order = (strcasecmp(order_str.c_str(), "DESC") == 0) ? DESC : ASC;
+
+		// run the select without the ORDER BY clause, then sort its result in place
+		if (regexMatchAndExecute(select_str) != SUCCESS)
+			return FAILURE;
+		return order_by_handler(targetRelName, attribute, order);
+
 	} else {
 		cout << "Syntax Error" << endl;
 		return FAILURE;
@@ -691,6 +902,17 @@ int getOperator(string op_str) {
 	return op;
 }
 
+/*
+ * Splits a WHERE clause of conditions joined with AND into the attributes, operators and values of the conditions
+ */
+void extract_conditions(string conditions_str, vector<string> &attributes, vector<int> &ops, vector<string> &values) {
+	for (sregex_iterator iter(conditions_str.begin(), conditions_str.end(), where_condition), end; iter != end; ++iter) {
+		attributes.push_back((*iter)[1]);
+		ops.push_back(getOperator((*iter)[2]));
+		values.push_back((*iter)[3]);
+	}
+}
+
 int getIndexOfWhereToken(vector<string> command_tokens) {
 	int index_of_where;
 	for (index_of_where = 0; index_of_where < command_tokens.size(); index_of_where++) {
@@ -811,6 +1033,46 @@ int select_attr_from_where_handler(char sourceRelName[ATTR_SIZE], char targetRel
 	}
 }
 
+int select_from_where_and_handler(char sourceRelName[ATTR_SIZE], char targetRelName[ATTR_SIZE], int cond_count,
+                                  char attributes[][ATTR_SIZE], int ops[], char values[][ATTR_SIZE]) {
+	int ret = select(sourceRelName, targetRelName, cond_count, attributes, ops, values);
+	if (ret == SUCCESS) {
+		cout << "Selected successfully, result in relation: ";
+		print16(targetRelName);
+	} else {
+		printErrorMsg(ret);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+int select_attr_from_where_and_handler(char sourceRelName[ATTR_SIZE], char targetRelName[ATTR_SIZE], int attr_count,
+                                       char attrs[][ATTR_SIZE], int cond_count, char attributes[][ATTR_SIZE], int ops[],
+                                       char values[][ATTR_SIZE]) {
+	int ret = select(sourceRelName, TEMP, cond_count, attributes, ops, values);
+	if (ret != SUCCESS) {
+		printErrorMsg(ret);
+		return FAILURE;
+	}
+
+	int relid = openRel(TEMP);
+	if (relid == E_RELNOTEXIST || relid == E_CACHEFULL) {
+		printErrorMsg(relid);
+		return FAILURE;
+	}
+	int ret_project = project(TEMP, targetRelName, attr_count, attrs);
+	closeRel(relid);
+	deleteRel(TEMP);
+	if (ret_project != SUCCESS) {
+		printErrorMsg(ret_project);
+		return FAILURE;
+	}
+	cout << "Selected successfully, result in relation: ";
+	print16(targetRelName);
+	return SUCCESS;
+}
+
 int select_attr_from_join_handler(char sourceRelOneName[ATTR_SIZE], char sourceRelTwoName[ATTR_SIZE],
                                   char targetRelName[ATTR_SIZE], int attrCount,
                                   char joinAttributeOne[ATTR_SIZE], char joinAttributeTwo[ATTR_SIZE],
@@ -847,6 +1109,49 @@ int select_attr_from_join_handler(char sourceRelOneName[ATTR_SIZE], char sourceR
 	}
 }
 
+/*
+ * Replaces the relation relName by its records sorted on the given attribute
+ * If they cannot be sorted, the error is reported and relName is kept as the select left it, unsorted.
+ * If the sorted relation cannot be renamed to relName, relName is kept unsorted and the sorted one is kept in TEMP.
+ */
+int order_by_handler(char relName[ATTR_SIZE], char attribute[ATTR_SIZE], int order) {
+	int relId = openRel(relName);
+	if (relId < 0) {
+		printErrorMsg(relId);
+		return FAILURE;
+	}
+
+	int ret = sort(relName, TEMP, attribute, order);
+	closeRel(relId);
+	if (ret != SUCCESS) {
+		deleteRel(TEMP);
+		printErrorMsg(ret);
+		cout << "Result left unsorted in relation: ";
+		print16(relName);
+		return FAILURE;
+	}
+
+	// move the unsorted relation aside, so that it can be put back if the sorted one cannot take its name
+	ret = renameRel(relName, SORT_UNSORTED_RELNAME);
+	if (ret == SUCCESS) {
+		ret = renameRel(TEMP, relName);
+		if (ret != SUCCESS)
+			renameRel(SORT_UNSORTED_RELNAME, relName);
+	}
+	if (ret != SUCCESS) {
+		printErrorMsg(ret);
+		cout << "Result left unsorted in relation: ";
+		print16(relName);
+		cout << "Sorted result kept in relation: ";
+		print16(TEMP);
+		return FAILURE;
+	}
+	deleteRel(SORT_UNSORTED_RELNAME);
+	cout << "Sorted successfully, result in relation: ";
+	print16(relName);
+	return SUCCESS;
+}
+
 void print16(char char_string_thing[ATTR_SIZE]) {
 	for (int i = 0; i < ATTR_SIZE; i++) {
 		if (char_string_thing[i] == '\0') {
@@ -917,16 +1222,22 @@ void display_help() {
 	printf("CLOSE TABLE tablename;\n\t-close the relation \n\n");
 	printf("CREATE INDEX ON tablename.attributename;\n\t-create an index on a given attribute.\n\n");
 	printf("DROP INDEX ON tablename.attributename;\n\t-delete the index.\n\n");
+	printf("CREATE INDEX ON tablename(attribute1, attribute2, ...);\n\t-create a composite index on an ordered list of up to %d attributes.\n\n", COMPOSITE_INDEX_MAX_ATTRS);
+	printf("DROP INDEX ON tablename(attribute1, attribute2, ...);\n\t-delete the composite index.\n\n");
 	printf("ALTER TABLE RENAME tablename TO new_tablename;\n\t-rename an existing relation to a given new name.\n\n");
 	printf("ALTER TABLE RENAME tablename COLUMN column_name TO new_column_name;\n\t-rename an attribute of an existing relation.\n\n");
 	printf("INSERT INTO tablename VALUES ( value1,value2,value3,... );\n\t-insert a single record into the given relation. \n\n");
 	printf("INSERT INTO tablename VALUES FROM filepath; \n\t-insert multiple records from a csv file \n\n");
+	printf("UPDATE tablename SET attrname1 = value1, attrname2 = value2 ... [WHERE attrname OP value AND ...];\n\t-set the attributes of the records satisfying all of the conditions, or of every record of the relation\n\n");
+	printf("DELETE FROM tablename [WHERE attrname1 OP value1 AND attrname2 OP value2 ...];\n\t-delete the records satisfying all of the conditions, or every record of the relation\n\n");
 	printf("SELECT * FROM source_relation INTO target_relation; \n\t-creates a relation with the same attributes and records as of source relation\n\n");
 	printf("SELECT Attribute1,Attribute2,....FROM source_relation INTO target_relation;\n\t-creates a relation with attributes specified and all records\n\n");
 	printf("SELECT * FROM source_relation INTO target_relation WHERE attrname OP value;\n\t-retrieve records based on a condition and insert them into a target relation\n\n");
 	printf("SELECT Attribute1,Attribute2,....FROM source_relation INTO target_relation;\n\t-creates a relation with the attributes specified and inserts those records which satisfy the given condition.\n\n");
+	printf("SELECT ... FROM source_relation INTO target_relation WHERE attrname1 OP value1 AND attrname2 OP value2 ...;\n\t-either of the two SELECT commands above, with the records satisfying all of the conditions\n\n");
 	printf("SELECT * FROM source_relation1 JOIN source_relation2 INTO target_relation WHERE source_relation1.attribute1 = source_relation2.attribute2;\n\t-creates a new relation with by equi-join of both the source relations\n\n");
 	printf("SELECT Attribute1,Attribute2,.. FROM source_relation1 JOIN source_relation2 INTO target_relation WHERE source_relation1.attribute1 = source_relation2.attribute2;\n\t-creates a new relation by equi-join of both the source relations with the attributes specified \n\n");
+	printf("SELECT ... INTO target_relation ... ORDER BY attrname [ASC|DESC];\n\t-any of the above SELECT commands, with the records of the target relation sorted on the given attribute (ascending by default)\n\n");
 	printf("exit \n\t-Exit the interface\n");
 	return;
 }
@@ -940,6 +1251,8 @@ void printErrorMsg(int ret) {
 		cout << "Error: Free slot" << endl;
 	else if (ret == E_NOINDEX)
 		cout << "Error: No index" << endl;
+	else if (ret == E_INDEXEXISTS)
+		cout << "Error: Index already exists" << endl;
 	else if (ret == E_DISKFULL)
 		cout << "Error: Insufficient space in Disk" << endl;
 	else if (ret == E_INVALIDBLOCK)
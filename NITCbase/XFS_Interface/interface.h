@@ -28,6 +28,8 @@ std::regex open_table("\\s*OPEN\\s+TABLE\\s+([A-Za-z0-9_-]+)\\s*;?", std::regex_
 std::regex close_table("\\s*CLOSE\\s+TABLE\\s+([A-Za-z0-9_-]+)\\s*;?", std::regex_constants::icase);
 std::regex create_index("\\s*CREATE\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*([#A-Za-z0-9_-]+)\\s*;?", std::regex_constants::icase);
 std::regex drop_index("\\s*DROP\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*([#A-Za-z0-9_-]+)\\s*;?", std::regex_constants::icase);
+std::regex create_composite_index("\\s*CREATE\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\(\\s*((?:[#A-Za-z0-9_-]+\\s*,\\s*)*[#A-Za-z0-9_-]+)\\s*\\)\\s*;?", std::regex_constants::icase);
+std::regex drop_composite_index("\\s*DROP\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\(\\s*((?:[#A-Za-z0-9_-]+\\s*,\\s*)*[#A-Za-z0-9_-]+)\\s*\\)\\s*;?", std::regex_constants::icase);
 std::regex rename_table("\\s*ALTER\\s+TABLE\\s+RENAME\\s+([a-zA-Z0-9_-]+)\\s+TO\\s+([a-zA-Z0-9_-]+)\\s*;?", std::regex_constants::icase);
 std::regex rename_column("\\s*ALTER\\s+TABLE\\s+RENAME\\s+([a-zA-Z0-9_-]+)\\s+COLUMN\\s+([#a-zA-Z0-9_-]+)\\s+TO\\s+([#a-zA-Z0-9_-]+)\\s*;?", std::regex_constants::icase);
 
@@ -36,11 +38,18 @@ std::regex select_from("\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s
 std::regex select_attr_from("\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*[#A-Za-z0-9_-]+)\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s*;?", std::regex_constants::icase);
 std::regex select_from_where("\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([#A-Za-z0-9_-]+)\\s*(<|<=|>|>=|=|!=)\\s*([A-Za-z0-9_-]+|([0-9]+(\\.)[0-9]+))\\s*;?", std::regex_constants::icase);
 std::regex select_attr_from_where("\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*[#A-Za-z0-9_-]+)\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([#A-Za-z0-9_-]+)\\s*(<|<=|>|>=|=|!=)\\s*([A-Za-z0-9_-]+|([0-9]+(\\.)[0-9]+))\\s*;?", std::regex_constants::icase);
+std::regex select_from_where_and("\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([#A-Za-z0-9_-]+\\s*(?:<|<=|>|>=|=|!=)\\s*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+)(?:\\s+AND\\s+[#A-Za-z0-9_-]+\\s*(?:<|<=|>|>=|=|!=)\\s*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+))+)\\s*;?", std::regex_constants::icase);
+std::regex select_attr_from_where_and("\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*[#A-Za-z0-9_-]+)\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([#A-Za-z0-9_-]+\\s*(?:<|<=|>|>=|=|!=)\\s*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+)(?:\\s+AND\\s+[#A-Za-z0-9_-]+\\s*(?:<|<=|>|>=|=|!=)\\s*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+))+)\\s*;?", std::regex_constants::icase);
 std::regex select_from_join("\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+JOIN\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*\\=\\s*([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*;?", std::regex_constants::icase);
 std::regex select_attr_from_join("\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*[#A-Za-z0-9_-]+)\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+JOIN\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*\\=\\s*([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*;?", std::regex_constants::icase);
+std::regex select_order_by("(\\s*SELECT\\s+.+?\\s+INTO\\s+)([A-Za-z0-9_-]+)(.*?)\\s+ORDER\\s+BY\\s+([#A-Za-z0-9_-]+)(?:\\s+(ASC|DESC))?\\s*;?", std::regex_constants::icase);
 std::regex insert_single("\\s*INSERT\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+VALUES\\s*\\(\\s*(([A-Za-z0-9_-]+|[0-9]+\\.[0-9]+)\\s*,\\s*)*([A-Za-z0-9_-]+|[0-9]+\\.[0-9]+)\\s*\\)\\s*;?", std::regex_constants::icase);
+std::regex delete_from("\\s*DELETE\\s+FROM\\s+([A-Za-z0-9_-]+)(?:\\s+WHERE\\s+([#A-Za-z0-9_-]+\\s*(?:<|<=|>|>=|=|!=)\\s*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+)(?:\\s+AND\\s+[#A-Za-z0-9_-]+\\s*(?:<|<=|>|>=|=|!=)\\s*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+))*))?\\s*;?", std::regex_constants::icase);
+std::regex update_set("\\s*UPDATE\\s+([A-Za-z0-9_-]+)\\s+SET\\s+([#A-Za-z0-9_-]+\\s*=\\s*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+)(?:\\s*,\\s*[#A-Za-z0-9_-]+\\s*=\\s*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+))*)(?:\\s+WHERE\\s+([#A-Za-z0-9_-]+\\s*(?:<|<=|>|>=|=|!=)\\s*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+)(?:\\s+AND\\s+[#A-Za-z0-9_-]+\\s*(?:<|<=|>|>=|=|!=)\\s*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+))*))?\\s*;?", std::regex_constants::icase);
 std::regex insert_multiple("\\s*INSERT\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+VALUES\\s+FROM\\s+([a-zA-Z0-9_-]+\\.csv)\\s*;?", std::regex_constants::icase);
 
 std::regex temp("\\((.*)\\)");
+// one condition of a WHERE clause joined with AND
+std::regex where_condition("([#A-Za-z0-9_-]+)\\s*(<=|>=|!=|<|>|=)\\s*([0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)");
 
 #endif  // NITCBASE_INTERFACE_H
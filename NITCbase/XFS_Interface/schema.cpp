@@ -5,6 +5,7 @@
 #include "block_access.h"
 #include "OpenRelTable.h"
 #include "BPlusTree.h"
+#include "composite_index.h"
 
 #include <string>
 #include <cstring>
@@ -68,8 +69,9 @@ int createRel(char relname[ATTR_SIZE], int nAttrs, char attrs[][ATTR_SIZE], int
 }
 
 int deleteRel(char relname[ATTR_SIZE]) {
-	if (strcmp(relname, "RELATIONCAT") == 0 || strcmp(relname, "ATTRIBUTECAT") == 0) {
-		std::cout << "Drop operation not permitted for Relation Catalog or Attribute Catalog" << std::endl;
+	if (strcmp(relname, "RELATIONCAT") == 0 || strcmp(relname, "ATTRIBUTECAT") == 0 ||
+	    strcmp(relname, INDEXCAT_RELNAME) == 0) {
+		std::cout << "Drop operation not permitted for Relation Catalog, Attribute Catalog or Index Catalog" << std::endl;
 		return E_INVALID;
 	}
 
@@ -86,7 +88,8 @@ int deleteRel(char relname[ATTR_SIZE]) {
 }
 
 int renameRel(char oldRelName[ATTR_SIZE], char newRelName[ATTR_SIZE]) {
-	if (strcmp(oldRelName, "RELATIONCAT") == 0 || strcmp(oldRelName, "ATTRIBUTECAT") == 0) {
+	if (strcmp(oldRelName, "RELATIONCAT") == 0 || strcmp(oldRelName, "ATTRIBUTECAT") == 0 ||
+	    strcmp(oldRelName, INDEXCAT_RELNAME) == 0) {
 		return E_INVALID;
 	}
 
@@ -100,7 +103,8 @@ int renameRel(char oldRelName[ATTR_SIZE], char newRelName[ATTR_SIZE]) {
 }
 
 int renameAtrribute(char relName[ATTR_SIZE], char oldAttrName[ATTR_SIZE], char newAttrName[ATTR_SIZE]) {
-	if (strcmp(relName, "RELATIONCAT") == 0 || strcmp(relName, "ATTRIBUTECAT") == 0) {
+	if (strcmp(relName, "RELATIONCAT") == 0 || strcmp(relName, "ATTRIBUTECAT") == 0 ||
+	    strcmp(relName, INDEXCAT_RELNAME) == 0) {
 		return E_INVALID;
 	}
 
@@ -129,7 +133,8 @@ int closeRel(int relid) {
 }
 
 int createIndex(char *relationName, char *attrName){
-	if (strcmp(relationName, "RELATIONCAT") == 0 || strcmp(relationName, "ATTRIBUTECAT") == 0) {
+	if (strcmp(relationName, "RELATIONCAT") == 0 || strcmp(relationName, "ATTRIBUTECAT") == 0 ||
+	    strcmp(relationName, INDEXCAT_RELNAME) == 0) {
 		std::cout << "Creating or Dropping index for attributes of Catalogs is an invalid operation" << std::endl;
 		return E_INVALID;
 	}
@@ -141,13 +146,25 @@ int createIndex(char *relationName, char *attrName){
 	if(relId == E_RELNOTOPEN) {
 		return E_RELNOTOPEN;
 	}
+
+	Attribute attrCatEntry[6];
+	int flag = getAttrCatEntry(relId, attrName, attrCatEntry);
+	// in case attribute does not exist
+	if (flag != SUCCESS) {
+		return E_ATTRNOTEXIST;
+	}
+	if ((int) attrCatEntry[ATTRCAT_ROOT_BLOCK_INDEX].nval != -1) {
+		return E_INDEXEXISTS;
+	}
+
 	BPlusTree bPlusTree = BPlusTree(relId, attrName);
 	int rootBlock = bPlusTree.getRootBlock();
 	return rootBlock;
 }
 
 int dropIndex(char *relationName, char *attrName){
-	if (strcmp(relationName, "RELATIONCAT") == 0 || strcmp(relationName, "ATTRIBUTECAT") == 0) {
+	if (strcmp(relationName, "RELATIONCAT") == 0 || strcmp(relationName, "ATTRIBUTECAT") == 0 ||
+	    strcmp(relationName, INDEXCAT_RELNAME) == 0) {
 		std::cout << "Creating or Dropping index for attributes of Catalogs is an invalid operation" << std::endl;
 		return E_INVALID;
 	}
@@ -182,6 +199,44 @@ int dropIndex(char *relationName, char *attrName){
 	return retVal;
 }
 
+/*
+ * Creates a composite index on an ordered list of attributes of an open relation
+ * Returns the root block of the index
+ */
+int createIndex(char *relationName, int numAttrs, char attrNames[][ATTR_SIZE]) {
+	if (strcmp(relationName, "RELATIONCAT") == 0 || strcmp(relationName, "ATTRIBUTECAT") == 0 ||
+	    strcmp(relationName, INDEXCAT_RELNAME) == 0) {
+		std::cout << "Creating or Dropping index for attributes of Catalogs is an invalid operation" << std::endl;
+		return E_INVALID;
+	}
+
+	int relId = OpenRelTable::getRelationId(relationName);
+	if (relId == E_RELNOTOPEN) {
+		return E_RELNOTOPEN;
+	}
+
+	if (check_duplicate_attributes(numAttrs, attrNames) == E_DUPLICATEATTR) {
+		return E_DUPLICATEATTR;
+	}
+
+	return createCompositeIndex(relId, numAttrs, attrNames);
+}
+
+int dropIndex(char *relationName, int numAttrs, char attrNames[][ATTR_SIZE]) {
+	if (strcmp(relationName, "RELATIONCAT") == 0 || strcmp(relationName, "ATTRIBUTECAT") == 0 ||
+	    strcmp(relationName, INDEXCAT_RELNAME) == 0) {
+		std::cout << "Creating or Dropping index for attributes of Catalogs is an invalid operation" << std::endl;
+		return E_INVALID;
+	}
+
+	int relId = OpenRelTable::getRelationId(relationName);
+	if (relId == E_RELNOTOPEN) {
+		return E_RELNOTOPEN;
+	}
+
+	return dropCompositeIndex(relId, numAttrs, attrNames);
+}
+
 /*gokul
  * Creates and returns a Relation Catalog Record Entry with the parameters provided as argument
  */
@@ -12,6 +12,8 @@ int closeRel(char rel_name[ATTR_SIZE]);
 int closeRel(int relid);
 int createIndex(char *relationName, char *attrName);
 int dropIndex(char *relationName, char *attrName);
+int createIndex(char *relationName, int numAttrs, char attrNames[][ATTR_SIZE]);
+int dropIndex(char *relationName, int numAttrs, char attrNames[][ATTR_SIZE]);
 
 Attribute *make_relcatrec(char relname[16], int nAttrs, int nRecords, int firstBlock, int lastBlock);
 Attribute* make_attrcatrec(char relname[ATTR_SIZE], char attrname[ATTR_SIZE], int attrtype, int rootBlock, int offset);
@@ -13,6 +13,20 @@ class Algebra {
   // Select
   static int select(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], char attr[ATTR_SIZE], int op, char strVal[ATTR_SIZE]);
 
+  // Select (records satisfying all numConditions conditions)
+  static int select(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], int numConditions, char attrs[][ATTR_SIZE],
+                    int ops[], char strVals[][ATTR_SIZE]);
+
+  // Delete (records satisfying all numConditions conditions, every record if there are none)
+  static int deleteRecords(char relName[ATTR_SIZE], int numConditions, char attrs[][ATTR_SIZE], int ops[],
+                           char strVals[][ATTR_SIZE]);
+
+  // Update (sets setAttrs to setStrVals in the records satisfying all numConditions conditions, in every record if
+  // there are none)
+  static int updateRecords(char relName[ATTR_SIZE], int numAssignments, char setAttrs[][ATTR_SIZE],
+                           char setStrVals[][ATTR_SIZE], int numConditions, char attrs[][ATTR_SIZE], int ops[],
+                           char strVals[][ATTR_SIZE]);
+
   // Project all (Copy)
   static int project(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE]);
 
@@ -22,6 +36,9 @@ class Algebra {
   // Join
   static int join(char srcRelOne[ATTR_SIZE], char srcRelTwo[ATTR_SIZE], char targetRel[ATTR_SIZE],
                   char attrOne[ATTR_SIZE], char attrTwo[ATTR_SIZE]);
+
+  // Sort (order is ASC or DESC)
+  static int sort(char srcRel[ATTR_SIZE], char targetRel[ATTR_SIZE], char attr[ATTR_SIZE], int order);
 };
 
 #endif  // NITCBASE_ALGEBRA_H
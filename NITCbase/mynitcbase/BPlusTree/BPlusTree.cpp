@@ -1,3 +1,85 @@
 #include "BPlusTree.h"
 
 #include <cstring>
+
+BPlusRangeScan::BPlusRangeScan(int rootBlock, int attrType) {
+  this->rootBlock = rootBlock;
+  this->attrType = attrType;
+  this->hasLower = false;
+  this->hasUpper = false;
+  // -2 : the scan has not yet seeked to its first leaf, -1 : the scan is over
+  this->nextLeaf = (rootBlock == -1) ? -1 : -2;
+}
+
+void BPlusRangeScan::setLowerBound(union Attribute value, bool inclusive) {
+  this->hasLower = true;
+  this->lower = value;
+  this->lowerInclusive = inclusive;
+}
+
+void BPlusRangeScan::setUpperBound(union Attribute value, bool inclusive) {
+  this->hasUpper = true;
+  this->upper = value;
+  this->upperInclusive = inclusive;
+}
+
+/*
+ * Copies the entries in range from the next leaf holding any into entries, in ascending order of attribute value.
+ * Returns their number, 0 once the scan is over, or an error code.
+ */
+int BPlusRangeScan::getNextBatch(Index entries[MAX_KEYS_LEAF]) {
+  bool firstLeaf = false;
+
+  if (this->nextLeaf == -2) {
+    // seek to the leaf holding the first entry >= (or >) the lower bound, or to the leftmost leaf
+    int block = this->rootBlock;
+    struct HeadInfo head;
+    BlockBuffer(block).getHeader(&head);
+    while (head.blockType == IND_INTERNAL) {
+      IndInternal internalBlk(block);
+      if (this->hasLower) {
+        block = internalBlk.findChild(this->lower, this->attrType, !this->lowerInclusive);
+      } else {
+        InternalEntry entry;
+        internalBlk.getEntry(&entry, 0);
+        block = entry.lChild;
+      }
+      if (block < 0) {
+        return block;
+      }
+      BlockBuffer(block).getHeader(&head);
+    }
+    this->nextLeaf = block;
+    firstLeaf = true;
+  }
+
+  while (this->nextLeaf != -1) {
+    IndLeaf leafBlk(this->nextLeaf);
+    struct HeadInfo head;
+    int ret = leafBlk.getHeader(&head);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+
+    int first = 0;
+    if (firstLeaf && this->hasLower) {
+      leafBlk.findEntry(this->lower, this->attrType, !this->lowerInclusive, &first);
+    }
+    firstLeaf = false;
+
+    int last = head.numEntries;
+    if (this->hasUpper) {
+      leafBlk.findEntry(this->upper, this->attrType, this->upperInclusive, &last);
+    }
+    // the scan is over at the first entry past the upper bound, or at the end of the leaf chain
+    this->nextLeaf = (last < head.numEntries) ? -1 : head.rblock;
+
+    for (int entryNum = first; entryNum < last; entryNum++) {
+      leafBlk.getEntry(&entries[entryNum - first], entryNum);
+    }
+    if (last > first) {
+      return last - first;
+    }
+  }
+  return 0;
+}
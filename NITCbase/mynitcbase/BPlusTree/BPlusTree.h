@@ -16,11 +16,40 @@ class BPlusTree {
   static int splitInternal(int intBlockNum, InternalEntry internalEntries[]);
   static int createNewRoot(int relId, char attrName[ATTR_SIZE], Attribute attrVal, int lChild, int rChild);
 
+  /* builds the tree bottom up over index entries sorted on attrVal, used by bPlusCreate; returns the root block */
+  static int bulkLoad(Index entries[], int numEntries);
+
  public:
   static int bPlusCreate(int relId, char attrName[ATTR_SIZE]);
   static int bPlusInsert(int relId, char attrName[ATTR_SIZE], union Attribute attrVal, RecId recordId);
+  /* adds entries in sorted order, or bulk loads a new tree from them merged with the tree's own entries if there are
+     at least 1/INDEX_REBUILD_RATIO of numExisting of them */
+  static int bPlusInsertBatch(int relId, char attrName[ATTR_SIZE], Index entries[], int numEntries, int numExisting);
+  static int bPlusDelete(int relId, char attrName[ATTR_SIZE], union Attribute attrVal, RecId recordId);
   static RecId bPlusSearch(int relId, char attrName[ATTR_SIZE], union Attribute attrVal, int op);
   static int bPlusDestroy(int rootBlockNum);
 };
 
+/*
+ * Scan of the entries of a B+ tree with attribute values between a lower and an upper bound, either of which
+ * may be left open. The first call to getNextBatch seeks down the tree to the lower bound, and each call then
+ * returns the entries in range from the next leaf, following the rblock links, until the first entry past the
+ * upper bound. Unlike bPlusSearch, the position is kept in the scan instead of the AttrCacheTable search index.
+ */
+class BPlusRangeScan {
+ private:
+  int rootBlock;
+  int attrType;
+  bool hasLower, lowerInclusive;
+  bool hasUpper, upperInclusive;
+  union Attribute lower, upper;
+  int nextLeaf;
+
+ public:
+  BPlusRangeScan(int rootBlock, int attrType);
+  void setLowerBound(union Attribute value, bool inclusive);
+  void setUpperBound(union Attribute value, bool inclusive);
+  int getNextBatch(Index entries[MAX_KEYS_LEAF]);
+};
+
 #endif  // NITCBASE_BPLUSTREE_H
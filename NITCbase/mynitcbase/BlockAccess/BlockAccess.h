@@ -1,6 +1,8 @@
 #ifndef NITCBASE_BLOCKACCESS_H
 #define NITCBASE_BLOCKACCESS_H
 
+#include <vector>
+
 #include "../BPlusTree/BPlusTree.h"
 #include "../Buffer/BlockBuffer.h"
 #include "../Cache/AttrCacheTable.h"
@@ -8,12 +10,35 @@
 #include "../define/constants.h"
 #include "../define/id.h"
 
+/*
+ * A bulk insert into an open relation: the index entries of the records written so far, which endBulkInsert adds to
+ * each index at once with BPlusTree::bPlusInsertBatch
+ */
+typedef struct BulkInsert {
+  int relId;
+  int numExisting;  // #Records of the relation when the bulk insert began
+  std::vector<int> attrOffsets;
+  std::vector<std::vector<Index>> attrEntries;
+} BulkInsert;
+
 class BlockAccess {
  public:
   static int search(int relId, Attribute *record, char *attrName, Attribute attrVal, int op);
 
   static int insert(int relId, union Attribute *record);
 
+  /* fills the free slots of the relation's blocks, then new blocks, a whole block at a time, updating #Records and
+     lastBlk once per batch; index entries are only collected into bulk */
+  static int beginBulkInsert(int relId, BulkInsert *bulk);
+  static int bulkInsert(BulkInsert *bulk, union Attribute records[], int numRecords);
+  static int endBulkInsert(BulkInsert *bulk);
+
+  /* removes the record from the indexes of the relation and clears its slot, releasing the block once empty */
+  static int deleteRecord(int relId, RecId recId);
+
+  /* overwrites the record in place, moving its entries in the indexes on the attributes whose values change */
+  static int updateRecord(int relId, RecId recId, union Attribute *record);
+
   static int renameRelation(char *oldName, char *newName);
 
   static int renameAttribute(char *relName, char *oldName, char *newName);
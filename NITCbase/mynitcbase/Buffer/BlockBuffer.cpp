@@ -1,4 +1,527 @@
 #include "BlockBuffer.h"
 
 #include <cstdlib>
-#include <cstring>
\ No newline at end of file
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define FILTER_X86
+#endif
+
+/*
+ * strcmp for STRING attributes, which are always ATTR_SIZE (16) bytes wide and so fit in one SSE register.
+ * The result is decided by the first byte that either differs or is the terminating NUL of str1,
+ * found for all 16 bytes at once. A value that fills all 16 bytes without a NUL compares like a
+ * 16 character string.
+ */
+static int compareStrings(const char *str1, const char *str2) {
+#ifdef FILTER_X86
+  __m128i a = _mm_loadu_si128((const __m128i *)str1);
+  __m128i b = _mm_loadu_si128((const __m128i *)str2);
+  unsigned int equal = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+  unsigned int terminator = _mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_setzero_si128()));
+  unsigned int decided = (~equal | terminator) & 0xFFFF;
+  if (decided == 0) {
+    return 0;
+  }
+  int pos = __builtin_ctz(decided);
+  return (int)(unsigned char)str1[pos] - (int)(unsigned char)str2[pos];
+#else
+  return strncmp(str1, str2, ATTR_SIZE);
+#endif
+}
+
+/*
+ * Returns a negative value, zero or a positive value as attr1 is less than, equal to or greater than attr2.
+ */
+int compareAttrs(Attribute attr1, Attribute attr2, int attrType) {
+  if (attrType == STRING) {
+    return compareStrings(attr1.sVal, attr2.sVal);
+  }
+
+  if (attr1.nVal < attr2.nVal) {
+    return -1;
+  } else if (attr1.nVal == attr2.nVal) {
+    return 0;
+  }
+  return 1;
+}
+
+/*
+ * Allocates a new block of the given type ('R', 'I' or 'L') on the disk.
+ * If no block could be allocated, blockNum holds the error code returned by getFreeBlock.
+ */
+BlockBuffer::BlockBuffer(char blockType) {
+  int blockTypeNum;
+  if (blockType == 'R') {
+    blockTypeNum = REC;
+  } else if (blockType == 'I') {
+    blockTypeNum = IND_INTERNAL;
+  } else if (blockType == 'L') {
+    blockTypeNum = IND_LEAF;
+  } else {
+    blockTypeNum = UNUSED_BLK;
+  }
+
+  this->blockNum = getFreeBlock(blockTypeNum);
+}
+
+BlockBuffer::BlockBuffer(int blockNum) {
+  this->blockNum = blockNum;
+}
+
+int BlockBuffer::getBlockNum() {
+  return this->blockNum;
+}
+
+/*
+ * Loads the block into a buffer frame if it is not already buffered and returns a pointer to the frame.
+ */
+int BlockBuffer::loadBlockAndGetBufferPtr(unsigned char **buffPtr) {
+  int bufferNum = StaticBuffer::getBufferNum(this->blockNum);
+  if (bufferNum == E_OUTOFBOUND) {
+    return E_OUTOFBOUND;
+  }
+
+  if (bufferNum != E_BLOCKNOTINBUFFER) {
+    StaticBuffer::touchBuffer(bufferNum);
+  } else {
+    bufferNum = StaticBuffer::getFreeBuffer(this->blockNum);
+    if (bufferNum == E_OUTOFBOUND) {
+      return E_OUTOFBOUND;
+    }
+    Disk::readBlock(StaticBuffer::blocks[bufferNum], this->blockNum);
+    StaticBuffer::stats.misses++;
+    StaticBuffer::readAhead(StaticBuffer::blocks[bufferNum]);
+  }
+
+  *buffPtr = StaticBuffer::blocks[bufferNum];
+  return SUCCESS;
+}
+
+/*
+ * Returns a read-only pointer to the block contents.
+ * In mmap mode an unbuffered block is read in place from the mapped run copy instead of being
+ * copied into a buffer frame. The pointer must not be written through.
+ */
+int BlockBuffer::loadBlockAndGetReadPtr(const unsigned char **buffPtr) {
+  int ret = StaticBuffer::getReadPtr(this->blockNum, buffPtr);
+  if (ret != E_BLOCKNOTINBUFFER) {
+    return ret;
+  }
+
+  unsigned char *bufferPtr;
+  ret = loadBlockAndGetBufferPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  *buffPtr = bufferPtr;
+  return SUCCESS;
+}
+
+int BlockBuffer::getHeader(struct HeadInfo *head) {
+  const unsigned char *bufferPtr;
+  int ret = loadBlockAndGetReadPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  memcpy(head, bufferPtr, sizeof(struct HeadInfo));
+  return SUCCESS;
+}
+
+int BlockBuffer::setHeader(struct HeadInfo *head) {
+  unsigned char *bufferPtr;
+  int ret = loadBlockAndGetBufferPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  /*
+   * Frames are only changed under bufferLock, where the background writer copies them, and the image
+   * from before the first change of a statement is kept for StaticBuffer::rollback
+   */
+  std::lock_guard<std::mutex> guard(StaticBuffer::bufferLock);
+  StaticBuffer::saveUndoImage(this->blockNum);
+  struct HeadInfo *bufferHeader = (struct HeadInfo *)bufferPtr;
+  bufferHeader->blockType = head->blockType;
+  bufferHeader->pblock = head->pblock;
+  bufferHeader->lblock = head->lblock;
+  bufferHeader->rblock = head->rblock;
+  bufferHeader->numEntries = head->numEntries;
+  bufferHeader->numAttrs = head->numAttrs;
+  bufferHeader->numSlots = head->numSlots;
+
+  return StaticBuffer::markDirty(this->blockNum);
+}
+
+int BlockBuffer::setBlockType(int blockType) {
+  unsigned char *bufferPtr;
+  int ret = loadBlockAndGetBufferPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(StaticBuffer::bufferLock);
+    StaticBuffer::saveUndoImage(this->blockNum);
+    *((int32_t *)bufferPtr) = blockType;
+    ret = StaticBuffer::markDirty(this->blockNum);
+  }
+  StaticBuffer::blockAllocMap[this->blockNum] = blockType;
+  StaticBuffer::setResidency(StaticBuffer::getBufferNum(this->blockNum));
+
+  return ret;
+}
+
+/*
+ * Allocates the first unused block on the disk, initialises its header and returns its block number.
+ * Returns E_DISKFULL if every block is in use.
+ */
+int BlockBuffer::getFreeBlock(int blockType) {
+  int freeBlock = -1;
+  for (int blockIndex = 0; blockIndex < DISK_BLOCKS; blockIndex++) {
+    if (StaticBuffer::blockAllocMap[blockIndex] == UNUSED_BLK) {
+      freeBlock = blockIndex;
+      break;
+    }
+  }
+
+  if (freeBlock == -1) {
+    return E_DISKFULL;
+  }
+
+  this->blockNum = freeBlock;
+  StaticBuffer::getFreeBuffer(freeBlock);
+
+  struct HeadInfo head;
+  head.pblock = -1;
+  head.lblock = -1;
+  head.rblock = -1;
+  head.numEntries = 0;
+  head.numAttrs = 0;
+  head.numSlots = 0;
+  setHeader(&head);
+  setBlockType(blockType);
+
+  return freeBlock;
+}
+
+/*
+ * Frees the block in the buffer and marks it unused in the block allocation map.
+ */
+void BlockBuffer::releaseBlock() {
+  if (this->blockNum == INVALID_BLOCKNUM || StaticBuffer::blockAllocMap[this->blockNum] == UNUSED_BLK) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(StaticBuffer::bufferLock);
+    StaticBuffer::saveUndoImage(this->blockNum);
+  }
+  int bufferNum = StaticBuffer::getBufferNum(this->blockNum);
+  if (bufferNum >= 0) {
+    StaticBuffer::releaseBuffer(bufferNum);
+  }
+
+  StaticBuffer::blockAllocMap[this->blockNum] = UNUSED_BLK;
+  this->blockNum = INVALID_BLOCKNUM;
+}
+
+RecBuffer::RecBuffer() : BlockBuffer('R') {}
+
+RecBuffer::RecBuffer(int blockNum) : BlockBuffer(blockNum) {}
+
+int RecBuffer::getSlotMap(unsigned char *slotMap) {
+  const unsigned char *bufferPtr;
+  int ret = loadBlockAndGetReadPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  const struct HeadInfo *head = (const struct HeadInfo *)bufferPtr;
+  memcpy(slotMap, bufferPtr + HEADER_SIZE, head->numSlots);
+  return SUCCESS;
+}
+
+int RecBuffer::setSlotMap(unsigned char *slotMap) {
+  unsigned char *bufferPtr;
+  int ret = loadBlockAndGetBufferPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  struct HeadInfo *head = (struct HeadInfo *)bufferPtr;
+  std::lock_guard<std::mutex> guard(StaticBuffer::bufferLock);
+  StaticBuffer::saveUndoImage(this->blockNum);
+  memcpy(bufferPtr + HEADER_SIZE, slotMap, head->numSlots);
+  return StaticBuffer::markDirty(this->blockNum);
+}
+
+int RecBuffer::getRecord(union Attribute *rec, int slotNum) {
+  const unsigned char *bufferPtr;
+  int ret = loadBlockAndGetReadPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  const struct HeadInfo *head = (const struct HeadInfo *)bufferPtr;
+  if (slotNum < 0 || slotNum >= head->numSlots) {
+    return E_OUTOFBOUND;
+  }
+
+  int recordSize = head->numAttrs * ATTR_SIZE;
+  memcpy(rec, bufferPtr + HEADER_SIZE + head->numSlots + slotNum * recordSize, recordSize);
+  return SUCCESS;
+}
+
+int RecBuffer::setRecord(union Attribute *rec, int slotNum) {
+  unsigned char *bufferPtr;
+  int ret = loadBlockAndGetBufferPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  struct HeadInfo *head = (struct HeadInfo *)bufferPtr;
+  if (slotNum < 0 || slotNum >= head->numSlots) {
+    return E_OUTOFBOUND;
+  }
+
+  int recordSize = head->numAttrs * ATTR_SIZE;
+  std::lock_guard<std::mutex> guard(StaticBuffer::bufferLock);
+  StaticBuffer::saveUndoImage(this->blockNum);
+  memcpy(bufferPtr + HEADER_SIZE + head->numSlots + slotNum * recordSize, rec, recordSize);
+  return StaticBuffer::markDirty(this->blockNum);
+}
+
+/*
+ * Marks an occupied slot free and decrements numEntries in the header, both in one buffer access.
+ * Returns the number of records left in the block (the caller releases the block when it reaches 0),
+ * E_FREESLOT if the slot was not occupied, or an error code.
+ */
+int RecBuffer::clearSlot(int slotNum) {
+  unsigned char *bufferPtr;
+  int ret = loadBlockAndGetBufferPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  struct HeadInfo *head = (struct HeadInfo *)bufferPtr;
+  if (slotNum < 0 || slotNum >= head->numSlots) {
+    return E_OUTOFBOUND;
+  }
+
+  unsigned char *slotMap = bufferPtr + HEADER_SIZE;
+  if (slotMap[slotNum] != SLOT_OCCUPIED) {
+    return E_FREESLOT;
+  }
+  std::lock_guard<std::mutex> guard(StaticBuffer::bufferLock);
+  StaticBuffer::saveUndoImage(this->blockNum);
+  slotMap[slotNum] = SLOT_UNOCCUPIED;
+  head->numEntries--;
+
+  ret = StaticBuffer::markDirty(this->blockNum);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+  return head->numEntries;
+}
+
+/*
+ * Copies the header, the slot map and every occupied record of the block into batch with a single
+ * buffer lookup, so that a scan can evaluate its predicate over the whole block in one tight loop
+ * instead of paying for a lookup and a header decode per slot.
+ * The occupied records are packed one after the other in batch->records (see RecordBatch).
+ */
+int RecBuffer::getRecords(struct RecordBatch *batch) {
+  const unsigned char *bufferPtr;
+  int ret = loadBlockAndGetReadPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  memcpy(&batch->head, bufferPtr, sizeof(struct HeadInfo));
+  int numSlots = batch->head.numSlots;
+  int recordSize = batch->head.numAttrs * ATTR_SIZE;
+  if (batch->head.blockType != REC || numSlots < 0 || HEADER_SIZE + numSlots * (1 + recordSize) > BLOCK_SIZE) {
+    return FAILURE;
+  }
+
+  const unsigned char *slotMap = bufferPtr + HEADER_SIZE;
+  const unsigned char *records = slotMap + numSlots;
+  memcpy(batch->slotMap, slotMap, numSlots);
+
+  // each run of consecutive occupied slots is copied with one memcpy
+  batch->numRecords = 0;
+  int slotNum = 0;
+  while (slotNum < numSlots) {
+    if (slotMap[slotNum] != SLOT_OCCUPIED) {
+      slotNum++;
+      continue;
+    }
+
+    int runStart = slotNum;
+    while (slotNum < numSlots && slotMap[slotNum] == SLOT_OCCUPIED) {
+      batch->slotNums[batch->numRecords + slotNum - runStart] = slotNum;
+      slotNum++;
+    }
+    memcpy((unsigned char *)batch->records + batch->numRecords * recordSize, records + runStart * recordSize,
+           (slotNum - runStart) * recordSize);
+    batch->numRecords += slotNum - runStart;
+  }
+
+  return SUCCESS;
+}
+
+IndBuffer::IndBuffer(char blockType) : BlockBuffer(blockType) {}
+
+IndBuffer::IndBuffer(int blockNum) : BlockBuffer(blockNum) {}
+
+/*
+ * Binary search over the keys of the block, read in place from the buffer: the key of entry i is at
+ * HEADER_SIZE + keyOffset + i * entrySize. Sets *entryNum to the index of the first entry whose key is
+ * greater than or equal to attrVal (greater than attrVal if strict), or to numEntries if there is none.
+ */
+int IndBuffer::searchKeys(int keyOffset, int entrySize, union Attribute attrVal, int attrType, bool strict,
+                          int *entryNum) {
+  const unsigned char *bufferPtr;
+  int ret = loadBlockAndGetReadPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  const struct HeadInfo *head = (const struct HeadInfo *)bufferPtr;
+  const unsigned char *keys = bufferPtr + HEADER_SIZE + keyOffset;
+  int low = 0, high = head->numEntries;
+  while (low < high) {
+    int mid = (low + high) / 2;
+    union Attribute key;
+    memcpy(&key, keys + mid * entrySize, ATTR_SIZE);
+    int flag = compareAttrs(key, attrVal, attrType);
+    if (flag < 0 || (strict && flag == 0)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  *entryNum = low;
+  return SUCCESS;
+}
+
+IndInternal::IndInternal() : IndBuffer('I') {}
+
+IndInternal::IndInternal(int blockNum) : IndBuffer(blockNum) {}
+
+/*
+ * Internal entries overlap: the rChild of entry i is the lChild of entry i + 1, so an entry starts
+ * every LCHILD_SIZE + ATTR_SIZE bytes although it is INTERNAL_ENTRY_SIZE bytes long.
+ */
+int IndInternal::getEntry(void *ptr, int indexNum) {
+  if (indexNum < 0 || indexNum >= MAX_KEYS_INTERNAL) {
+    return E_OUTOFBOUND;
+  }
+
+  const unsigned char *bufferPtr;
+  int ret = loadBlockAndGetReadPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  struct InternalEntry *internalEntry = (struct InternalEntry *)ptr;
+  const unsigned char *entryPtr = bufferPtr + HEADER_SIZE + indexNum * (LCHILD_SIZE + ATTR_SIZE);
+  memcpy(&internalEntry->lChild, entryPtr, LCHILD_SIZE);
+  memcpy(&internalEntry->attrVal, entryPtr + LCHILD_SIZE, ATTR_SIZE);
+  memcpy(&internalEntry->rChild, entryPtr + LCHILD_SIZE + ATTR_SIZE, LCHILD_SIZE);
+  return SUCCESS;
+}
+
+int IndInternal::setEntry(void *ptr, int indexNum) {
+  if (indexNum < 0 || indexNum >= MAX_KEYS_INTERNAL) {
+    return E_OUTOFBOUND;
+  }
+
+  unsigned char *bufferPtr;
+  int ret = loadBlockAndGetBufferPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  struct InternalEntry *internalEntry = (struct InternalEntry *)ptr;
+  unsigned char *entryPtr = bufferPtr + HEADER_SIZE + indexNum * (LCHILD_SIZE + ATTR_SIZE);
+  std::lock_guard<std::mutex> guard(StaticBuffer::bufferLock);
+  StaticBuffer::saveUndoImage(this->blockNum);
+  memcpy(entryPtr, &internalEntry->lChild, LCHILD_SIZE);
+  memcpy(entryPtr + LCHILD_SIZE, &internalEntry->attrVal, ATTR_SIZE);
+  memcpy(entryPtr + LCHILD_SIZE + ATTR_SIZE, &internalEntry->rChild, LCHILD_SIZE);
+  return StaticBuffer::markDirty(this->blockNum);
+}
+
+int IndInternal::findEntry(union Attribute attrVal, int attrType, bool strict, int *entryNum) {
+  return searchKeys(LCHILD_SIZE, LCHILD_SIZE + ATTR_SIZE, attrVal, attrType, strict, entryNum);
+}
+
+/*
+ * Returns the child to descend into to reach the first key greater than or equal to attrVal (greater than
+ * attrVal if strict): the lChild of the first entry with such a key, or the rChild of the last entry.
+ * Used by BPlusTree::bPlusSearch and BPlusTree::findLeafToInsert instead of a linear scan of the entries.
+ */
+int IndInternal::findChild(union Attribute attrVal, int attrType, bool strict) {
+  int entryNum;
+  int ret = findEntry(attrVal, attrType, strict, &entryNum);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  const unsigned char *bufferPtr;
+  ret = loadBlockAndGetReadPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  // the lChild of entry numEntries is the rChild of the last entry
+  int32_t child;
+  memcpy(&child, bufferPtr + HEADER_SIZE + entryNum * (LCHILD_SIZE + ATTR_SIZE), LCHILD_SIZE);
+  return child;
+}
+
+IndLeaf::IndLeaf() : IndBuffer('L') {}
+
+IndLeaf::IndLeaf(int blockNum) : IndBuffer(blockNum) {}
+
+int IndLeaf::getEntry(void *ptr, int indexNum) {
+  if (indexNum < 0 || indexNum >= MAX_KEYS_LEAF) {
+    return E_OUTOFBOUND;
+  }
+
+  const unsigned char *bufferPtr;
+  int ret = loadBlockAndGetReadPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  memcpy(ptr, bufferPtr + HEADER_SIZE + indexNum * LEAF_ENTRY_SIZE, LEAF_ENTRY_SIZE);
+  return SUCCESS;
+}
+
+int IndLeaf::setEntry(void *ptr, int indexNum) {
+  if (indexNum < 0 || indexNum >= MAX_KEYS_LEAF) {
+    return E_OUTOFBOUND;
+  }
+
+  unsigned char *bufferPtr;
+  int ret = loadBlockAndGetBufferPtr(&bufferPtr);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  std::lock_guard<std::mutex> guard(StaticBuffer::bufferLock);
+  StaticBuffer::saveUndoImage(this->blockNum);
+  memcpy(bufferPtr + HEADER_SIZE + indexNum * LEAF_ENTRY_SIZE, ptr, LEAF_ENTRY_SIZE);
+  return StaticBuffer::markDirty(this->blockNum);
+}
+
+int IndLeaf::findEntry(union Attribute attrVal, int attrType, bool strict, int *entryNum) {
+  return searchKeys(0, LEAF_ENTRY_SIZE, attrVal, attrType, strict, entryNum);
+}
@@ -25,6 +25,19 @@ typedef union Attribute {
 
 int compareAttrs(Attribute attr1, Attribute attr2, int attrType);
 
+/*
+ * All occupied records of a record block, decoded with a single buffer access.
+ * The i-th occupied record lives in slot slotNums[i] and its attributes are
+ * records[i * head.numAttrs] to records[(i + 1) * head.numAttrs - 1].
+ */
+struct RecordBatch {
+  struct HeadInfo head;
+  int numRecords;
+  unsigned char slotMap[BLOCK_SIZE - HEADER_SIZE];
+  int slotNums[BLOCK_SIZE - HEADER_SIZE];
+  union Attribute records[(BLOCK_SIZE - HEADER_SIZE) / ATTR_SIZE];
+};
+
 struct InternalEntry {
   int32_t lChild;
   union Attribute attrVal;
@@ -44,6 +57,7 @@ class BlockBuffer {
   int blockNum;
   // methods
   int loadBlockAndGetBufferPtr(unsigned char **buffPtr);
+  int loadBlockAndGetReadPtr(const unsigned char **buffPtr);
   int getFreeBlock(int blockType);
   int setBlockType(int blockType);
 
@@ -66,14 +80,20 @@ class RecBuffer : public BlockBuffer {
   int setSlotMap(unsigned char *slotMap);
   int getRecord(union Attribute *rec, int slotNum);
   int setRecord(union Attribute *rec, int slotNum);
+  int clearSlot(int slotNum);
+  int getRecords(struct RecordBatch *batch);
 };
 
 class IndBuffer : public BlockBuffer {
+ protected:
+  int searchKeys(int keyOffset, int entrySize, union Attribute attrVal, int attrType, bool strict, int *entryNum);
+
  public:
   IndBuffer(int blockNum);
   IndBuffer(char blockType);
   virtual int getEntry(void *ptr, int indexNum) = 0;
   virtual int setEntry(void *ptr, int indexNum) = 0;
+  virtual int findEntry(union Attribute attrVal, int attrType, bool strict, int *entryNum) = 0;
 };
 
 class IndInternal : public IndBuffer {
@@ -82,6 +102,8 @@ class IndInternal : public IndBuffer {
   IndInternal(int blockNum);
   int getEntry(void *ptr, int indexNum);
   int setEntry(void *ptr, int indexNum);
+  int findEntry(union Attribute attrVal, int attrType, bool strict, int *entryNum);
+  int findChild(union Attribute attrVal, int attrType, bool strict);
 };
 
 class IndLeaf : public IndBuffer {
@@ -90,6 +112,7 @@ class IndLeaf : public IndBuffer {
   IndLeaf(int blockNum);
   int getEntry(void *ptr, int indexNum);
   int setEntry(void *ptr, int indexNum);
+  int findEntry(union Attribute attrVal, int attrType, bool strict, int *entryNum);
 };
 
 #endif  // NITCBASE_BLOCKBUFFER_H
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "ReplacementPolicy.h"
+
+FrameList::FrameList(int capacity) : prev(capacity, -1), next(capacity, -1), member(capacity, false) {
+  head = -1;
+  tail = -1;
+  count = 0;
+}
+
+void FrameList::pushFront(int bufferNum) {
+  prev[bufferNum] = -1;
+  next[bufferNum] = head;
+  if (head != -1) {
+    prev[head] = bufferNum;
+  } else {
+    tail = bufferNum;
+  }
+  head = bufferNum;
+  member[bufferNum] = true;
+  count++;
+}
+
+void FrameList::remove(int bufferNum) {
+  if (!member[bufferNum]) {
+    return;
+  }
+
+  if (prev[bufferNum] != -1) {
+    next[prev[bufferNum]] = next[bufferNum];
+  } else {
+    head = next[bufferNum];
+  }
+  if (next[bufferNum] != -1) {
+    prev[next[bufferNum]] = prev[bufferNum];
+  } else {
+    tail = prev[bufferNum];
+  }
+  member[bufferNum] = false;
+  count--;
+}
+
+bool FrameList::contains(int bufferNum) {
+  return member[bufferNum];
+}
+
+int FrameList::size() {
+  return count;
+}
+
+int FrameList::last() {
+  return tail;
+}
+
+ReplacementPolicy *ReplacementPolicy::create(int policyType, int capacity) {
+  if (policyType == POLICY_LRU) {
+    return new LruPolicy(capacity);
+  } else if (policyType == POLICY_CLOCK) {
+    return new ClockPolicy(capacity);
+  }
+  return new TwoQueuePolicy(capacity);
+}
+
+/* LRU */
+
+LruPolicy::LruPolicy(int capacity) : recency(capacity) {}
+
+void LruPolicy::onLoad(int bufferNum, int /* blockNum */) {
+  recency.pushFront(bufferNum);
+}
+
+void LruPolicy::onAccess(int bufferNum) {
+  recency.remove(bufferNum);
+  recency.pushFront(bufferNum);
+}
+
+void LruPolicy::onRelease(int bufferNum) {
+  recency.remove(bufferNum);
+}
+
+int LruPolicy::chooseVictim() {
+  int victim = recency.last();
+  recency.remove(victim);
+  return victim;
+}
+
+/* CLOCK */
+
+ClockPolicy::ClockPolicy(int capacity) : referenced(capacity, false), occupied(capacity, false) {
+  this->capacity = capacity;
+  hand = 0;
+}
+
+void ClockPolicy::onLoad(int bufferNum, int /* blockNum */) {
+  occupied[bufferNum] = true;
+  referenced[bufferNum] = false;
+}
+
+void ClockPolicy::onAccess(int bufferNum) {
+  referenced[bufferNum] = true;
+}
+
+void ClockPolicy::onRelease(int bufferNum) {
+  occupied[bufferNum] = false;
+  referenced[bufferNum] = false;
+}
+
+/*
+ * Sweeps the hand over the frames, clearing reference bits until it finds an unreferenced frame.
+ * One full sweep clears every bit, so the hand stops within two sweeps.
+ */
+int ClockPolicy::chooseVictim() {
+  int victim = -1;
+  while (victim == -1) {
+    int bufferNum = hand;
+    hand = (hand + 1) % capacity;
+    if (!occupied[bufferNum]) {
+      continue;
+    }
+    if (referenced[bufferNum]) {
+      referenced[bufferNum] = false;
+    } else {
+      victim = bufferNum;
+    }
+  }
+
+  onRelease(victim);
+  return victim;
+}
+
+/* 2Q */
+
+TwoQueuePolicy::TwoQueuePolicy(int capacity)
+    : a1in(capacity), am(capacity), ghostCount(DISK_BLOCKS, 0), blockOfFrame(capacity, -1) {
+  /*
+   * a1in gets a quarter of the frames as suggested by Johnson and Shasha. Ghosts only cost a block number,
+   * so a1out remembers twice as many blocks as the pool holds to recognise hot blocks across longer scans.
+   */
+  a1inTarget = capacity / 4 > 1 ? capacity / 4 : 1;
+  a1outCapacity = 2 * capacity;
+  a1out.assign(a1outCapacity, -1);
+  a1outHead = 0;
+  a1outSize = 0;
+}
+
+/*
+ * Adds an evicted block to the ring of ghosts, forgetting the oldest ghost when the ring is full.
+ * A block may be in the ring more than once, so membership is a count.
+ */
+void TwoQueuePolicy::rememberEvicted(int blockNum) {
+  if (a1outSize == a1outCapacity) {
+    ghostCount[a1out[a1outHead]]--;
+  } else {
+    a1outSize++;
+  }
+  a1out[a1outHead] = blockNum;
+  ghostCount[blockNum]++;
+  a1outHead = (a1outHead + 1) % a1outCapacity;
+}
+
+void TwoQueuePolicy::onLoad(int bufferNum, int blockNum) {
+  blockOfFrame[bufferNum] = blockNum;
+  if (ghostCount[blockNum] > 0) {
+    am.pushFront(bufferNum);
+  } else {
+    a1in.pushFront(bufferNum);
+  }
+}
+
+/* A hit in a1in is most likely part of the same burst of references, so only am keeps recency */
+void TwoQueuePolicy::onAccess(int bufferNum) {
+  if (am.contains(bufferNum)) {
+    am.remove(bufferNum);
+    am.pushFront(bufferNum);
+  }
+}
+
+void TwoQueuePolicy::onRelease(int bufferNum) {
+  a1in.remove(bufferNum);
+  am.remove(bufferNum);
+  blockOfFrame[bufferNum] = -1;
+}
+
+int TwoQueuePolicy::chooseVictim() {
+  bool fromA1in = a1in.size() > a1inTarget || am.size() == 0;
+  int victim = fromA1in ? a1in.last() : am.last();
+
+  if (fromA1in) {
+    rememberEvicted(blockOfFrame[victim]);
+  }
+  onRelease(victim);
+  return victim;
+}
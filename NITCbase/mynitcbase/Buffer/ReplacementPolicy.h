@@ -0,0 +1,105 @@
+#ifndef NITCBASE_REPLACEMENTPOLICY_H
+#define NITCBASE_REPLACEMENTPOLICY_H
+
+#include <vector>
+
+#include "../define/constants.h"
+
+enum ReplacementPolicyType {
+  POLICY_LRU = 0,    // evicts the least recently used frame
+  POLICY_CLOCK = 1,  // second chance approximation of LRU
+  POLICY_2Q = 2      // blocks must be referenced twice before they can push out the hot set
+};
+
+/*
+ * Doubly linked list of buffer frames threaded through arrays indexed by frame number.
+ * The head is the most recently inserted frame.
+ */
+class FrameList {
+ private:
+  std::vector<int> prev;
+  std::vector<int> next;
+  std::vector<bool> member;
+  int head;
+  int tail;
+  int count;
+
+ public:
+  FrameList(int capacity);
+  void pushFront(int bufferNum);
+  void remove(int bufferNum);
+  bool contains(int bufferNum);
+  int size();
+  int last();
+};
+
+/*
+ * Decides which occupied frame StaticBuffer reuses when no frame is free.
+ * Resident frames are never reported to the policy, so every frame it tracks can be chosen.
+ * chooseVictim stops tracking the frame it returns, StaticBuffer then reports the new block with onLoad.
+ */
+class ReplacementPolicy {
+ public:
+  static ReplacementPolicy *create(int policyType, int capacity);
+  virtual ~ReplacementPolicy() {}
+  virtual void onLoad(int bufferNum, int blockNum) = 0;
+  virtual void onAccess(int bufferNum) = 0;
+  virtual void onRelease(int bufferNum) = 0;
+  virtual int chooseVictim() = 0;
+};
+
+class LruPolicy : public ReplacementPolicy {
+ private:
+  FrameList recency;
+
+ public:
+  LruPolicy(int capacity);
+  void onLoad(int bufferNum, int blockNum);
+  void onAccess(int bufferNum);
+  void onRelease(int bufferNum);
+  int chooseVictim();
+};
+
+class ClockPolicy : public ReplacementPolicy {
+ private:
+  int capacity;
+  int hand;
+  std::vector<bool> referenced;
+  std::vector<bool> occupied;
+
+ public:
+  ClockPolicy(int capacity);
+  void onLoad(int bufferNum, int blockNum);
+  void onAccess(int bufferNum);
+  void onRelease(int bufferNum);
+  int chooseVictim();
+};
+
+/*
+ * Simplified 2Q: newly loaded blocks enter the FIFO a1in, and only blocks that are loaded again while
+ * remembered in the ghost queue a1out are admitted to the LRU list am. A sequential scan therefore
+ * only cycles through a1in and leaves the frames in am alone.
+ */
+class TwoQueuePolicy : public ReplacementPolicy {
+ private:
+  FrameList a1in;
+  FrameList am;
+  int a1inTarget;
+  int a1outCapacity;
+  std::vector<int> a1out;
+  int a1outHead;
+  int a1outSize;
+  std::vector<int> ghostCount;
+  std::vector<int> blockOfFrame;
+
+  void rememberEvicted(int blockNum);
+
+ public:
+  TwoQueuePolicy(int capacity);
+  void onLoad(int bufferNum, int blockNum);
+  void onAccess(int bufferNum);
+  void onRelease(int bufferNum);
+  int chooseVictim();
+};
+
+#endif  // NITCBASE_REPLACEMENTPOLICY_H
@@ -1 +1,579 @@
 #include "StaticBuffer.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "BlockBuffer.h"
+
+int StaticBuffer::bufferCapacity = BUFFER_CAPACITY;
+bool StaticBuffer::hugePages = false;
+bool StaticBuffer::arenaMapped = false;
+unsigned char (*StaticBuffer::blocks)[BLOCK_SIZE] = nullptr;
+struct BufferMetaInfo *StaticBuffer::metainfo = nullptr;
+unsigned char StaticBuffer::blockAllocMap[DISK_BLOCKS];
+unsigned char StaticBuffer::loggedAllocMap[DISK_BLOCKS];
+int StaticBuffer::bufferOfBlock[DISK_BLOCKS];
+int *StaticBuffer::freeBuffers = nullptr;
+int StaticBuffer::numFreeBuffers = 0;
+struct BufferCounters StaticBuffer::stats;
+ReplacementPolicy *StaticBuffer::policy = nullptr;
+int StaticBuffer::numResident = 0;
+int StaticBuffer::readAheadBlocks = READ_AHEAD_BLOCKS;
+int StaticBuffer::readAheadStart = -1;
+int StaticBuffer::readAheadEnd = -1;
+std::mutex StaticBuffer::bufferLock;
+std::thread StaticBuffer::flusher;
+std::condition_variable StaticBuffer::flusherWake;
+std::condition_variable StaticBuffer::flushDone;
+bool StaticBuffer::flusherStop = false;
+std::vector<int> StaticBuffer::undoBlocks;
+std::vector<unsigned char> StaticBuffer::undoImages;
+bool StaticBuffer::undoSaved[DISK_BLOCKS];
+
+/* Size of the block arena, rounded up to whole 2 MB pages when it is backed by huge pages */
+static size_t arenaBytes(int capacity, bool hugePages) {
+  const size_t hugePageSize = 2 * 1024 * 1024;
+  size_t bytes = (size_t)capacity * BLOCK_SIZE;
+  return hugePages ? (bytes + hugePageSize - 1) / hugePageSize * hugePageSize : bytes;
+}
+
+/*
+ * Loads the block allocation map from the first BLOCK_ALLOCATION_MAP_SIZE blocks of the disk
+ * and marks every buffer frame as free.
+ * Block numbers are bounded by DISK_BLOCKS, so bufferOfBlock maps a block straight to its frame (-1 if unbuffered).
+ * The number of frames is BUFFER_CAPACITY unless overridden by BUFFER_BLOCKS_ENV. All frames live in one
+ * page aligned arena, backed by huge pages when the system has them reserved.
+ */
+StaticBuffer::StaticBuffer() {
+  const char *capacityEnv = std::getenv(BUFFER_BLOCKS_ENV);
+  if (capacityEnv != nullptr) {
+    char *end;
+    long capacity = std::strtol(capacityEnv, &end, 10);
+    if (end != capacityEnv && *end == '\0' && capacity >= MIN_BUFFER_CAPACITY && capacity <= DISK_BLOCKS) {
+      bufferCapacity = (int)capacity;
+    }
+  }
+
+  void *arena = mmap(nullptr, arenaBytes(bufferCapacity, true), PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  hugePages = arena != MAP_FAILED;
+  if (!hugePages) {
+    arena = mmap(nullptr, arenaBytes(bufferCapacity, false), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+                 0);
+    if (arena != MAP_FAILED) {
+      madvise(arena, arenaBytes(bufferCapacity, false), MADV_HUGEPAGE);
+    }
+  }
+  arenaMapped = arena != MAP_FAILED;
+  if (!arenaMapped) {
+    /* Without an arena the Buffer keeps the default capacity on the heap */
+    bufferCapacity = BUFFER_CAPACITY;
+    arena = std::aligned_alloc(BLOCK_SIZE, (size_t)bufferCapacity * BLOCK_SIZE);
+  }
+  blocks = (unsigned char(*)[BLOCK_SIZE])arena;
+  metainfo = new struct BufferMetaInfo[bufferCapacity];
+  freeBuffers = new int[bufferCapacity];
+
+  int policyType = POLICY_2Q;
+  const char *policyEnv = std::getenv(BUFFER_POLICY_ENV);
+  if (policyEnv != nullptr && strcmp(policyEnv, "lru") == 0) {
+    policyType = POLICY_LRU;
+  } else if (policyEnv != nullptr && strcmp(policyEnv, "clock") == 0) {
+    policyType = POLICY_CLOCK;
+  }
+  policy = ReplacementPolicy::create(policyType, bufferCapacity);
+
+  const char *readAheadEnv = std::getenv(READ_AHEAD_ENV);
+  if (readAheadEnv != nullptr) {
+    char *end;
+    long blocksAhead = std::strtol(readAheadEnv, &end, 10);
+    if (end != readAheadEnv && *end == '\0' && blocksAhead >= 0 && blocksAhead <= DISK_BLOCKS) {
+      readAheadBlocks = (int)blocksAhead;
+    }
+  }
+
+  for (int blockIndex = 0; blockIndex < BLOCK_ALLOCATION_MAP_SIZE; blockIndex++) {
+    Disk::readBlock(blockAllocMap + blockIndex * BLOCK_SIZE, blockIndex);
+  }
+  memcpy(loggedAllocMap, blockAllocMap, DISK_BLOCKS);
+
+  for (int bufferIndex = 0; bufferIndex < bufferCapacity; bufferIndex++) {
+    metainfo[bufferIndex].free = true;
+    metainfo[bufferIndex].dirty = false;
+    metainfo[bufferIndex].logged = false;
+    metainfo[bufferIndex].resident = false;
+    metainfo[bufferIndex].flushing = false;
+    metainfo[bufferIndex].version = 0;
+    metainfo[bufferIndex].blockNum = -1;
+  }
+
+  for (int blockIndex = 0; blockIndex < DISK_BLOCKS; blockIndex++) {
+    bufferOfBlock[blockIndex] = -1;
+  }
+
+  /* Frames are handed out from the top of the stack, lowest index first */
+  numFreeBuffers = bufferCapacity;
+  for (int bufferIndex = 0; bufferIndex < bufferCapacity; bufferIndex++) {
+    freeBuffers[bufferIndex] = bufferCapacity - 1 - bufferIndex;
+  }
+
+  const char *flusherEnv = std::getenv(BUFFER_FLUSHER_ENV);
+  if (flusherEnv == nullptr || strcmp(flusherEnv, "0") != 0) {
+    flusherStop = false;
+    flusher = std::thread(flushLoop);
+  }
+}
+
+/*
+ * Stops the background writer, then writes the block allocation map and every dirty buffer frame back to the disk.
+ */
+StaticBuffer::~StaticBuffer() {
+  if (flusher.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(bufferLock);
+      flusherStop = true;
+    }
+    flusherWake.notify_one();
+    flusher.join();
+  }
+
+  bool mapLogged = memcmp(blockAllocMap, loggedAllocMap, DISK_BLOCKS) == 0;
+  Disk::writeBlocks(blockAllocMap, 0, BLOCK_ALLOCATION_MAP_SIZE, mapLogged);
+  flushDirtyBuffers(bufferCapacity);
+
+  if (std::getenv(BUFFER_STATS_ENV) != nullptr) {
+    struct BufferStats total;
+    getStats(&total);
+    long long accesses = total.hits + total.misses + total.mappedReads;
+    fprintf(stderr, "buffer: %d frames%s, %lld accesses, %lld hits (%.1f%%), %lld misses, %lld mapped reads, "
+            "%lld evictions, %lld write backs, %lld read aheads, %lld background writes, %lld checkpoints\n",
+            bufferCapacity, hugePages ? " (huge pages)" : "", accesses, total.hits,
+            accesses > 0 ? 100.0 * total.hits / accesses : 0.0, total.misses, total.mappedReads, total.evictions,
+            total.writeBacks, total.readAheads, total.flushes, total.checkpoints);
+  }
+
+  if (arenaMapped) {
+    munmap(blocks, arenaBytes(bufferCapacity, hugePages));
+  } else {
+    std::free(blocks);
+  }
+  delete policy;
+  delete[] metainfo;
+  delete[] freeBuffers;
+}
+
+/*
+ * Assigns a buffer frame to the given block and returns its index.
+ * When no frame is free, the frame chosen by the replacement policy is written back (if dirty) and reused.
+ * A victim the background writer is still writing out is waited for, so its older copy cannot land on the
+ * disk after the write back.
+ */
+int StaticBuffer::getFreeBuffer(int blockNum) {
+  if (blockNum < 0 || blockNum > DISK_BLOCKS - 1) {
+    return E_OUTOFBOUND;
+  }
+
+  std::unique_lock<std::mutex> lock(bufferLock);
+  int bufferNum;
+  if (numFreeBuffers > 0) {
+    bufferNum = freeBuffers[--numFreeBuffers];
+  } else {
+    bufferNum = policy->chooseVictim();
+    flushDone.wait(lock, [bufferNum] { return !metainfo[bufferNum].flushing; });
+
+    if (metainfo[bufferNum].dirty) {
+      Disk::writeBlock(blocks[bufferNum], metainfo[bufferNum].blockNum, metainfo[bufferNum].logged);
+      stats.writeBacks++;
+    }
+    stats.evictions++;
+    bufferOfBlock[metainfo[bufferNum].blockNum] = -1;
+  }
+
+  metainfo[bufferNum].free = false;
+  metainfo[bufferNum].dirty = false;
+  metainfo[bufferNum].logged = false;
+  metainfo[bufferNum].resident = false;
+  metainfo[bufferNum].version++;
+  metainfo[bufferNum].blockNum = blockNum;
+  bufferOfBlock[blockNum] = bufferNum;
+  policy->onLoad(bufferNum, blockNum);
+  setResidency(bufferNum);
+
+  return bufferNum;
+}
+
+/*
+ * Tells the replacement policy that a buffered block was accessed again.
+ */
+void StaticBuffer::touchBuffer(int bufferNum) {
+  if (!metainfo[bufferNum].resident) {
+    policy->onAccess(bufferNum);
+  }
+  stats.hits++;
+}
+
+/*
+ * Keeps the relation catalog, the first attribute catalog block and internal index blocks resident,
+ * since every search goes through them. Resident frames are left out of the replacement policy.
+ * At most half the frames are resident, so a full pool always leaves the policy a victim.
+ */
+void StaticBuffer::setResidency(int bufferNum) {
+  int blockNum = metainfo[bufferNum].blockNum;
+  bool resident = blockNum == RELCAT_BLOCK || blockNum == ATTRCAT_BLOCK || blockAllocMap[blockNum] == IND_INTERNAL;
+
+  if (resident && !metainfo[bufferNum].resident && numResident < bufferCapacity / 2) {
+    policy->onRelease(bufferNum);
+    metainfo[bufferNum].resident = true;
+    numResident++;
+  } else if (!resident && metainfo[bufferNum].resident) {
+    metainfo[bufferNum].resident = false;
+    numResident--;
+    policy->onLoad(bufferNum, blockNum);
+  }
+}
+
+/*
+ * Returns the index of the buffer frame holding the given block, or E_BLOCKNOTINBUFFER if it is not buffered.
+ */
+int StaticBuffer::getBufferNum(int blockNum) {
+  if (blockNum < 0 || blockNum > DISK_BLOCKS - 1) {
+    return E_OUTOFBOUND;
+  }
+
+  int bufferNum = bufferOfBlock[blockNum];
+  return bufferNum == -1 ? E_BLOCKNOTINBUFFER : bufferNum;
+}
+
+/*
+ * Returns a frame to the free list without writing it back (used when its block is released).
+ */
+void StaticBuffer::releaseBuffer(int bufferNum) {
+  std::unique_lock<std::mutex> lock(bufferLock);
+  flushDone.wait(lock, [bufferNum] { return !metainfo[bufferNum].flushing; });
+  if (metainfo[bufferNum].free) {
+    return;
+  }
+
+  policy->onRelease(bufferNum);
+  if (metainfo[bufferNum].resident) {
+    numResident--;
+  }
+
+  bufferOfBlock[metainfo[bufferNum].blockNum] = -1;
+  metainfo[bufferNum].free = true;
+  metainfo[bufferNum].dirty = false;
+  metainfo[bufferNum].resident = false;
+  metainfo[bufferNum].blockNum = -1;
+  freeBuffers[numFreeBuffers++] = bufferNum;
+}
+
+/*
+ * Returns a read-only pointer to the contents of the given block without loading it into a buffer frame.
+ * A buffered copy always wins, since it may hold changes that are not on the disk yet.
+ * Otherwise the block is served straight from the mapped run copy when the disk is in mmap mode.
+ * Returns E_BLOCKNOTINBUFFER if the block has to be loaded into a frame first.
+ */
+int StaticBuffer::getReadPtr(int blockNum, const unsigned char **blockPtr) {
+  int bufferNum = getBufferNum(blockNum);
+  if (bufferNum == E_OUTOFBOUND) {
+    return E_OUTOFBOUND;
+  }
+
+  if (bufferNum != E_BLOCKNOTINBUFFER) {
+    *blockPtr = blocks[bufferNum];
+    touchBuffer(bufferNum);
+    return SUCCESS;
+  }
+
+  const unsigned char *mappedBlock = Disk::getMappedBlock(blockNum);
+  if (mappedBlock == nullptr) {
+    return E_BLOCKNOTINBUFFER;
+  }
+
+  *blockPtr = mappedBlock;
+  stats.mappedReads++;
+  readAhead(mappedBlock);
+  return SUCCESS;
+}
+
+/*
+ * Called with the contents of a block that just had to come from the disk.
+ * Record blocks and leaf index blocks are read in rblock order by scans, so the next readAheadBlocks
+ * blocks from the right sibling on are requested in the background. Blocks of a relation are mostly
+ * allocated one after another, so the window usually covers the following siblings as well and is
+ * only renewed once the chain leaves it.
+ */
+void StaticBuffer::readAhead(const unsigned char *block) {
+  const struct HeadInfo *head = (const struct HeadInfo *)block;
+  if (readAheadBlocks == 0 || (head->blockType != REC && head->blockType != IND_LEAF)) {
+    return;
+  }
+
+  int nextBlock = head->rblock;
+  if (nextBlock < 0 || nextBlock > DISK_BLOCKS - 1 || bufferOfBlock[nextBlock] != -1) {
+    return;
+  }
+  if (nextBlock >= readAheadStart && nextBlock < readAheadEnd) {
+    return;
+  }
+
+  Disk::prefetchBlocks(nextBlock, readAheadBlocks);
+  readAheadStart = nextBlock;
+  readAheadEnd = nextBlock + readAheadBlocks;
+  stats.readAheads++;
+}
+
+/*
+ * Keeps the image a block had before its first change in the current unit of work, so that rollback can
+ * put it back. Blocks that were unused at the last commit are skipped, as they are unused again after a
+ * rollback. An unbuffered block (one being released) is read from the disk.
+ * The caller must hold bufferLock, and call this before changing the frame.
+ */
+void StaticBuffer::saveUndoImage(int blockNum) {
+  if (blockNum < 0 || blockNum > DISK_BLOCKS - 1 || undoSaved[blockNum]) {
+    return;
+  }
+  undoSaved[blockNum] = true;
+  if (loggedAllocMap[blockNum] == UNUSED_BLK) {
+    return;
+  }
+
+  undoBlocks.push_back(blockNum);
+  undoImages.resize(undoBlocks.size() * BLOCK_SIZE);
+  unsigned char *image = undoImages.data() + (undoBlocks.size() - 1) * BLOCK_SIZE;
+  int bufferNum = bufferOfBlock[blockNum];
+  if (bufferNum != -1) {
+    memcpy(image, blocks[bufferNum], BLOCK_SIZE);
+  } else {
+    Disk::readBlock(image, blockNum);
+  }
+}
+
+/*
+ * Ends the current unit of work (one frontend statement).
+ * Dirty frames and changed blocks of the allocation map only reach the disk on replacement or shutdown,
+ * so their current images are logged before the commit to make the statement recoverable.
+ */
+int StaticBuffer::commit() {
+  std::lock_guard<std::mutex> guard(bufferLock);
+  undoBlocks.clear();
+  undoImages.clear();
+  memset(undoSaved, 0, sizeof(undoSaved));
+
+  for (int bufferIndex = 0; bufferIndex < bufferCapacity; bufferIndex++) {
+    if (!metainfo[bufferIndex].free && metainfo[bufferIndex].dirty && !metainfo[bufferIndex].logged) {
+      WriteAheadLog::logBlock(blocks[bufferIndex], metainfo[bufferIndex].blockNum);
+      metainfo[bufferIndex].logged = true;
+    }
+  }
+
+  for (int blockIndex = 0; blockIndex < BLOCK_ALLOCATION_MAP_SIZE; blockIndex++) {
+    unsigned char *mapBlock = blockAllocMap + blockIndex * BLOCK_SIZE;
+    unsigned char *loggedBlock = loggedAllocMap + blockIndex * BLOCK_SIZE;
+    if (memcmp(mapBlock, loggedBlock, BLOCK_SIZE) != 0) {
+      WriteAheadLog::logBlock(mapBlock, blockIndex);
+      memcpy(loggedBlock, mapBlock, BLOCK_SIZE);
+    }
+  }
+
+  return WriteAheadLog::commit();
+}
+
+/*
+ * Ends a unit of work that failed without committing it: the allocation map goes back to the one logged by
+ * the last commit, every block changed since then gets back its image from before the change, and the block
+ * records logged since the commit are dropped from the log.
+ * The restored frames are left dirty, so that they also replace any changed copy the disk got meanwhile.
+ */
+int StaticBuffer::rollback() {
+  std::vector<int> changedBlocks;
+  std::vector<unsigned char> images;
+  {
+    std::lock_guard<std::mutex> guard(bufferLock);
+    memcpy(blockAllocMap, loggedAllocMap, DISK_BLOCKS);
+    changedBlocks.swap(undoBlocks);
+    images.swap(undoImages);
+    memset(undoSaved, 0, sizeof(undoSaved));
+  }
+
+  int ret = SUCCESS;
+  for (size_t index = 0; index < changedBlocks.size(); index++) {
+    int blockNum = changedBlocks[index];
+    int bufferNum = getBufferNum(blockNum);
+    if (bufferNum == E_BLOCKNOTINBUFFER) {
+      bufferNum = getFreeBuffer(blockNum);
+    }
+    if (bufferNum < 0) {
+      ret = bufferNum;
+      continue;
+    }
+
+    std::lock_guard<std::mutex> guard(bufferLock);
+    memcpy(blocks[bufferNum], images.data() + index * BLOCK_SIZE, BLOCK_SIZE);
+    markDirty(blockNum);
+    setResidency(bufferNum);
+  }
+
+  /* Frames of blocks allocated by the failed unit of work are not needed any more */
+  for (int bufferIndex = 0; bufferIndex < bufferCapacity; bufferIndex++) {
+    int blockNum = metainfo[bufferIndex].blockNum;
+    if (!metainfo[bufferIndex].free && blockAllocMap[blockNum] == UNUSED_BLK) {
+      releaseBuffer(bufferIndex);
+    }
+  }
+
+  /* Images logged by evictions while restoring are dropped as well, the restored frames are still dirty */
+  std::lock_guard<std::mutex> guard(bufferLock);
+  int logRet = WriteAheadLog::rollback();
+  return ret == SUCCESS ? logRet : ret;
+}
+
+int StaticBuffer::setDirtyBit(int blockNum) {
+  std::lock_guard<std::mutex> guard(bufferLock);
+  return markDirty(blockNum);
+}
+
+/*
+ * Marks the frame holding the given block as changed since it was last written and logged.
+ * The caller must hold bufferLock, and should hold it while changing the frame as well, so that
+ * the background writer never copies a half written frame.
+ */
+int StaticBuffer::markDirty(int blockNum) {
+  int bufferNum = getBufferNum(blockNum);
+  if (bufferNum == E_BLOCKNOTINBUFFER || bufferNum == E_OUTOFBOUND) {
+    return bufferNum;
+  }
+
+  metainfo[bufferNum].dirty = true;
+  metainfo[bufferNum].logged = false;
+  metainfo[bufferNum].version++;
+  return SUCCESS;
+}
+
+/*
+ * Writes up to maxBlocks dirty frames back to the disk in block number order, one write per run of
+ * adjacent block numbers. Returns the number of frames written.
+ * The frames are copied, and logged if they are not in the log yet, under bufferLock, where writers
+ * change them. The lock is dropped for the writes themselves. A frame changed after it was copied has a
+ * new version and stays dirty, and eviction waits for frames still being written (see getFreeBuffer).
+ */
+int StaticBuffer::flushDirtyBuffers(int maxBlocks) {
+  std::unique_lock<std::mutex> lock(bufferLock);
+  std::vector<std::pair<int, int>> dirtyBlocks;
+  for (int bufferIndex = 0; bufferIndex < bufferCapacity; bufferIndex++) {
+    if (!metainfo[bufferIndex].free && metainfo[bufferIndex].dirty && !metainfo[bufferIndex].flushing) {
+      dirtyBlocks.push_back(std::make_pair(metainfo[bufferIndex].blockNum, bufferIndex));
+    }
+  }
+  std::sort(dirtyBlocks.begin(), dirtyBlocks.end());
+  if ((int)dirtyBlocks.size() > maxBlocks) {
+    dirtyBlocks.resize(maxBlocks);
+  }
+
+  /* Images are logged here, in the same order as the commits of the foreground */
+  std::vector<unsigned char> images(dirtyBlocks.size() * BLOCK_SIZE);
+  std::vector<unsigned int> versions(dirtyBlocks.size());
+  for (size_t index = 0; index < dirtyBlocks.size(); index++) {
+    int bufferNum = dirtyBlocks[index].second;
+    unsigned char *image = images.data() + index * BLOCK_SIZE;
+    memcpy(image, blocks[bufferNum], BLOCK_SIZE);
+    if (!metainfo[bufferNum].logged && WriteAheadLog::logBlock(image, dirtyBlocks[index].first) == SUCCESS) {
+      metainfo[bufferNum].logged = true;
+    }
+    versions[index] = metainfo[bufferNum].version;
+    metainfo[bufferNum].flushing = true;
+  }
+  lock.unlock();
+
+  std::vector<bool> written(dirtyBlocks.size(), false);
+  size_t runStart = 0;
+  for (size_t index = 0; index < dirtyBlocks.size(); index++) {
+    bool runEnds = index + 1 == dirtyBlocks.size() || dirtyBlocks[index + 1].first != dirtyBlocks[index].first + 1;
+    if (runEnds) {
+      int runLength = index + 1 - runStart;
+      if (Disk::writeBlocks(images.data() + runStart * BLOCK_SIZE, dirtyBlocks[runStart].first, runLength, true) ==
+          SUCCESS) {
+        std::fill(written.begin() + runStart, written.begin() + index + 1, true);
+      }
+      runStart = index + 1;
+    }
+  }
+
+  lock.lock();
+  for (size_t index = 0; index < dirtyBlocks.size(); index++) {
+    struct BufferMetaInfo &frame = metainfo[dirtyBlocks[index].second];
+    frame.flushing = false;
+    /* An image that did not make it into the log stays dirty, so it is logged and written again later */
+    if (written[index] && frame.logged && frame.version == versions[index]) {
+      frame.dirty = false;
+    }
+  }
+  flushDone.notify_all();
+
+  return dirtyBlocks.size();
+}
+
+/*
+ * Body of the background writer. Every FLUSH_INTERVAL_MS it writes back a batch of dirty frames so that
+ * replacement usually finds a clean victim, and every CHECKPOINT_INTERVAL_MS it checkpoints the
+ * write-ahead log into the disk, provided no statement is half way through.
+ * bufferLock is only held while waiting, the writes and the checkpoint run without it so the foreground is
+ * not held up.
+ */
+void StaticBuffer::flushLoop() {
+  auto lastCheckpoint = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(bufferLock);
+
+  while (!flusherStop) {
+    flusherWake.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS));
+    if (flusherStop) {
+      break;
+    }
+    lock.unlock();
+
+    int flushed = flushDirtyBuffers(FLUSH_BATCH_BLOCKS);
+
+    /* Only a checkpoint that emptied the log counts, it is put off while records after the last commit are in it */
+    auto now = std::chrono::steady_clock::now();
+    bool checkpointed = now - lastCheckpoint >= std::chrono::milliseconds(CHECKPOINT_INTERVAL_MS) &&
+                        WriteAheadLog::checkpoint() == SUCCESS;
+    if (checkpointed) {
+      lastCheckpoint = now;
+      stats.checkpoints++;
+    }
+    stats.flushes += flushed;
+
+    lock.lock();
+  }
+}
+
+int StaticBuffer::getCapacity() {
+  return bufferCapacity;
+}
+
+/*
+ * Copies the buffer access counters of the current session into statsBuf
+ */
+void StaticBuffer::getStats(struct BufferStats *statsBuf) {
+  statsBuf->hits = stats.hits;
+  statsBuf->misses = stats.misses;
+  statsBuf->mappedReads = stats.mappedReads;
+  statsBuf->evictions = stats.evictions;
+  statsBuf->writeBacks = stats.writeBacks;
+  statsBuf->readAheads = stats.readAheads;
+  statsBuf->flushes = stats.flushes;
+  statsBuf->checkpoints = stats.checkpoints;
+}
+
+int StaticBuffer::getStaticBlockType(int blockNum) {
+  if (blockNum < 0 || blockNum > DISK_BLOCKS - 1) {
+    return E_OUTOFBOUND;
+  }
+
+  return (int)blockAllocMap[blockNum];
+}
@@ -1,33 +1,110 @@
 #ifndef NITCBASE_STATICBUFFER_H
 #define NITCBASE_STATICBUFFER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "../Disk_Class/Disk.h"
+#include "../Disk_Class/WriteAheadLog.h"
 #include "../define/constants.h"
+#include "ReplacementPolicy.h"
 
 struct BufferMetaInfo {
   bool free;
   bool dirty;
+  bool logged;    // the current contents are already in the write-ahead log
+  bool resident;  // catalog or internal index block, kept while other frames can be replaced
+  bool flushing;  // a copy of the frame is being written by the background writer
+  unsigned int version;  // bumped on every change, tells the background writer if its copy is still current
   int blockNum;
-  int timeStamp;
+};
+
+/*
+ * Counters for the block accesses served by the buffer, as copied out by StaticBuffer::getStats
+ */
+struct BufferStats {
+  long long hits;         // block found in a buffer frame
+  long long misses;       // block read from the disk into a buffer frame
+  long long mappedReads;  // block read in place from the mapped run copy
+  long long evictions;    // frame taken away from another block
+  long long writeBacks;   // dirty frame written to the disk on eviction
+  long long readAheads;   // read-ahead requests issued along block chains
+  long long flushes;      // dirty frames written by the background writer
+  long long checkpoints;  // checkpoints taken by the background writer
+};
+
+/*
+ * The live counters behind BufferStats. flushes and checkpoints are updated by the background writer and the
+ * others by the foreground, without holding bufferLock, so each of them is atomic.
+ */
+struct BufferCounters {
+  std::atomic<long long> hits;
+  std::atomic<long long> misses;
+  std::atomic<long long> mappedReads;
+  std::atomic<long long> evictions;
+  std::atomic<long long> writeBacks;
+  std::atomic<long long> readAheads;
+  std::atomic<long long> flushes;
+  std::atomic<long long> checkpoints;
 };
 
 class StaticBuffer {
   friend class BlockBuffer;
+  friend class RecBuffer;
+  friend class IndInternal;
+  friend class IndLeaf;
 
  private:
   // fields
-  static unsigned char blocks[BUFFER_CAPACITY][BLOCK_SIZE];
-  static struct BufferMetaInfo metainfo[BUFFER_CAPACITY];
+  static int bufferCapacity;
+  static bool hugePages;
+  static bool arenaMapped;
+  static unsigned char (*blocks)[BLOCK_SIZE];
+  static struct BufferMetaInfo *metainfo;
   static unsigned char blockAllocMap[DISK_BLOCKS];
+  static unsigned char loggedAllocMap[DISK_BLOCKS];
+  static int bufferOfBlock[DISK_BLOCKS];
+  static int *freeBuffers;
+  static int numFreeBuffers;
+  static struct BufferCounters stats;
+  static ReplacementPolicy *policy;
+  static int numResident;
+  static int readAheadBlocks;
+  static int readAheadStart;
+  static int readAheadEnd;
+  static std::mutex bufferLock;
+  static std::thread flusher;
+  static std::condition_variable flusherWake;
+  static std::condition_variable flushDone;
+  static bool flusherStop;
+  static std::vector<int> undoBlocks;
+  static std::vector<unsigned char> undoImages;
+  static bool undoSaved[DISK_BLOCKS];
 
   // methods
   static int getFreeBuffer(int blockNum);
   static int getBufferNum(int blockNum);
+  static void touchBuffer(int bufferNum);
+  static void setResidency(int bufferNum);
+  static void releaseBuffer(int bufferNum);
+  static void readAhead(const unsigned char *block);
+  static void saveUndoImage(int blockNum);
+  static int getReadPtr(int blockNum, const unsigned char **blockPtr);
+  static int markDirty(int blockNum);
+  static int flushDirtyBuffers(int maxBlocks);
+  static void flushLoop();
 
  public:
   // methods
   static int getStaticBlockType(int blockNum);
   static int setDirtyBit(int blockNum);
+  static int commit();
+  static int rollback();
+  static int getCapacity();
+  static void getStats(struct BufferStats *statsBuf);
   StaticBuffer();
   ~StaticBuffer();
 };
@@ -1,6 +1,8 @@
 #ifndef NITCBASE_RELCACHETABLE_H
 #define NITCBASE_RELCACHETABLE_H
 
+#include <cstdint>
+
 #include "../Buffer/BlockBuffer.h"
 #include "../define/constants.h"
 #include "../define/id.h"
@@ -20,6 +22,10 @@ typedef struct RelCacheEntry {
   bool dirty;
   RecId recId;
   RecId searchIndex;
+  // record blocks of the relation with a free slot (one bit per disk block), built on the first insert after the
+  // relation is opened and kept up to date by BlockAccess::insert and BlockAccess::deleteRecord
+  bool freeSpaceMapValid;
+  uint64_t freeSpaceMap[DISK_BLOCKS / 64];
 
 } RelCacheEntry;
 
@@ -33,6 +39,9 @@ class RelCacheTable {
   static int getSearchIndex(int relId, RecId *searchIndex);
   static int setSearchIndex(int relId, RecId *searchIndex);
   static int resetSearchIndex(int relId);
+  // a block of the relation with a free slot, or -1 if every block is full (builds the map if needed)
+  static int getFreeSpaceBlock(int relId);
+  static int setFreeSpace(int relId, int blockNum, bool hasFreeSlot);
 
  private:
   // field
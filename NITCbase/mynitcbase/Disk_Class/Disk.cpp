@@ -1,31 +1,117 @@
 #include "Disk.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
 #include "../define/constants.h"
+#include "WriteAheadLog.h"
+
+int Disk::runCopyFd = -1;
+int Disk::mode = DISK_MODE_PREAD;
+unsigned char *Disk::mappedDisk = nullptr;
+struct DiskCounters Disk::stats;
+std::atomic<bool> Disk::runCopyClean(false);
+std::mutex Disk::writeLock;
+
+/* Tags the clean marker */
+static const int64_t CLEAN_MARKER_MAGIC = 0x4e49544344534b43;
+
+/* Makes creation and removal of files in the disk directory durable */
+static void syncDiskDir() {
+  int dirFd = open(DISK_DIR_PATH, O_RDONLY | O_DIRECTORY);
+  if (dirFd != -1) {
+    fsync(dirFd);
+    close(dirFd);
+  }
+}
+
+static long long nanosSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
 
 /*
  * Used to make a temporary copy of the disk contents before the starting of a new session.
  * This ensures that if the system has a forced shutdown during the course of the session,
  * the previous state of the disk is not lost.
+ * The copy is skipped when the clean marker shows that the run copy left by the last session still matches the disk.
  */
 Disk::Disk() {
-  /* An efficient method to copy files */
-  /* Copy Disk to Disk Run Copy */
-  std::ifstream src(DISK_PATH, std::ios::binary);
-  std::ofstream dst(DISK_RUN_COPY_PATH, std::ios::binary);
+  /* Bring the disk up to date with the committed work of a session that crashed */
+  int walRet = WriteAheadLog::open();
 
-  dst << src.rdbuf();
-  src.close();
-  dst.close();
+  struct DiskCleanMarker expected, recorded;
+  bool runCopyMatches = false;
+  if (walRet == SUCCESS && getCleanMarker(&expected) == SUCCESS) {
+    int markerFd = open(DISK_CLEAN_MARKER_PATH, O_RDONLY);
+    if (markerFd != -1) {
+      runCopyMatches = read(markerFd, &recorded, sizeof(recorded)) == sizeof(recorded) &&
+                       std::memcmp(&recorded, &expected, sizeof(recorded)) == 0;
+      close(markerFd);
+    }
+  }
+
+  struct stat runCopyStat;
+  if (runCopyMatches && (stat(DISK_RUN_COPY_PATH, &runCopyStat) != 0 || runCopyStat.st_size != expected.size)) {
+    runCopyMatches = false;
+  }
+
+  if (!runCopyMatches) {
+    /* An efficient method to copy files */
+    /* Copy Disk to Disk Run Copy */
+    unlink(DISK_CLEAN_MARKER_PATH);
+    std::ifstream src(DISK_PATH, std::ios::binary);
+    std::ofstream dst(DISK_RUN_COPY_PATH, std::ios::binary);
+
+    dst << src.rdbuf();
+    src.close();
+    dst.close();
+  }
+
+  /* The run copy stays open for the whole session, block I/O is served by positioned reads and writes */
+  int fd = openRunCopy();
+
+  if (runCopyMatches) {
+    runCopyClean = true;
+  } else if (fd != FAILURE && fsync(fd) == 0) {
+    runCopyClean = writeCleanMarker() == SUCCESS;
+  }
+
+  /* In mmap mode the whole run copy is mapped, falling back to pread/pwrite if it cannot be mapped */
+  const char *diskMode = std::getenv(DISK_MODE_ENV);
+  if (diskMode != nullptr && std::strcmp(diskMode, "mmap") == 0 && mapRunCopy() == SUCCESS) {
+    mode = DISK_MODE_MMAP;
+  }
 }
 
 /*
  * Used to update the changes made to the disk on graceful termination of the latest session.
  * This ensures that these changes are visible in future sessions.
+ * Every block written during the session is in the write-ahead log, so a final checkpoint brings the disk up to date.
  */
 Disk::~Disk() {
+  if (WriteAheadLog::close() == SUCCESS) {
+    if (mappedDisk != nullptr) {
+      msync(mappedDisk, (size_t)DISK_BLOCKS * BLOCK_SIZE, MS_SYNC);
+    }
+    if (!runCopyClean && runCopyFd != -1 && fsync(runCopyFd) == 0) {
+      writeCleanMarker();
+    }
+    unmapRunCopy();
+    closeRunCopy();
+    return;
+  }
+
+  unmapRunCopy();
+  closeRunCopy();
+
   /* An efficient method to copy files */
   /* Copy Disk Run Copy to Disk */
   std::ifstream src(DISK_RUN_COPY_PATH, std::ios::binary);
@@ -36,6 +122,119 @@ Disk::~Disk() {
   dst.close();
 }
 
+/*
+ * Opens the run copy of the disk for the session if it is not already open.
+ * Returns the file descriptor, or FAILURE if the run copy could not be opened.
+ */
+int Disk::openRunCopy() {
+  if (runCopyFd == -1) {
+    runCopyFd = open(DISK_RUN_COPY_PATH, O_RDWR);
+  }
+  return runCopyFd == -1 ? FAILURE : runCopyFd;
+}
+
+void Disk::closeRunCopy() {
+  if (runCopyFd != -1) {
+    close(runCopyFd);
+    runCopyFd = -1;
+  }
+}
+
+/*
+ * Maps all DISK_BLOCKS blocks of the run copy into memory.
+ * The mapping is shared, so stores into it reach the run copy without any further syscall.
+ */
+int Disk::mapRunCopy() {
+  const size_t diskBytes = (size_t)DISK_BLOCKS * BLOCK_SIZE;
+  struct stat runCopyStat;
+  int fd = openRunCopy();
+  if (fd == FAILURE || fstat(fd, &runCopyStat) != 0 || (size_t)runCopyStat.st_size < diskBytes) {
+    return FAILURE;
+  }
+
+  void *mapping = mmap(nullptr, diskBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    return FAILURE;
+  }
+  mappedDisk = (unsigned char *)mapping;
+  return SUCCESS;
+}
+
+/*
+ * Flushes the mapped run copy to the file and removes the mapping
+ */
+void Disk::unmapRunCopy() {
+  if (mappedDisk != nullptr) {
+    const size_t diskBytes = (size_t)DISK_BLOCKS * BLOCK_SIZE;
+    msync(mappedDisk, diskBytes, MS_SYNC);
+    munmap(mappedDisk, diskBytes);
+    mappedDisk = nullptr;
+    mode = DISK_MODE_PREAD;
+  }
+}
+
+/*
+ * Fills marker with the identity of the disk file as it is right now
+ */
+int Disk::getCleanMarker(struct DiskCleanMarker *marker) {
+  struct stat diskStat;
+  if (stat(DISK_PATH, &diskStat) != 0) {
+    return FAILURE;
+  }
+
+  std::memset(marker, 0, sizeof(struct DiskCleanMarker));
+  marker->magic = CLEAN_MARKER_MAGIC;
+  marker->inode = diskStat.st_ino;
+  marker->size = diskStat.st_size;
+  marker->mtimeSec = diskStat.st_mtim.tv_sec;
+  marker->mtimeNsec = diskStat.st_mtim.tv_nsec;
+  return SUCCESS;
+}
+
+/*
+ * Records that the run copy matches the disk in its current state.
+ * The disk can still be changed by other tools (eg. XFS Interface) between sessions, so the marker
+ * stores the identity of the disk file and is only trusted while that identity is unchanged.
+ */
+int Disk::writeCleanMarker() {
+  struct DiskCleanMarker marker;
+  if (getCleanMarker(&marker) != SUCCESS) {
+    return FAILURE;
+  }
+
+  int markerFd = open(DISK_CLEAN_MARKER_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (markerFd == -1) {
+    return FAILURE;
+  }
+  bool written = write(markerFd, &marker, sizeof(marker)) == sizeof(marker) && fsync(markerFd) == 0;
+  close(markerFd);
+  syncDiskDir();
+
+  if (!written) {
+    unlink(DISK_CLEAN_MARKER_PATH);
+    return FAILURE;
+  }
+  runCopyClean = true;
+  return SUCCESS;
+}
+
+/*
+ * Withdraws the clean marker before the first change of the session reaches the run copy.
+ * Blocks are written both by the foreground and by the background writer of the Buffer, so the
+ * marker is withdrawn under writeLock.
+ */
+void Disk::markRunCopyDirty() {
+  if (!runCopyClean) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(writeLock);
+  if (runCopyClean) {
+    unlink(DISK_CLEAN_MARKER_PATH);
+    syncDiskDir();
+    runCopyClean = false;
+  }
+}
+
 /*
  * Used to Read a specified block from disk
  * block - Memory pointer of the buffer to which the block contents is to be loaded/read.
@@ -43,15 +242,28 @@ Disk::~Disk() {
  * blockNum - Block number of the disk block to be read.
  */
 int Disk::readBlock(unsigned char *block, int blockNum) {
-  FILE *disk = fopen(DISK_RUN_COPY_PATH, "rb");
   if (blockNum < 0 || blockNum > DISK_BLOCKS - 1) {
     return E_OUTOFBOUND;
   }
-  const int offset = blockNum * BLOCK_SIZE;
-  fseek(disk, offset, SEEK_SET);
-  fread(block, BLOCK_SIZE, 1, disk);
-  fclose(disk);
-  return SUCCESS;
+
+  if (mode == DISK_MODE_MMAP) {
+    std::memcpy(block, mappedDisk + (size_t)blockNum * BLOCK_SIZE, BLOCK_SIZE);
+    stats.reads++;
+    return SUCCESS;
+  }
+
+  int fd = openRunCopy();
+  if (fd == FAILURE) {
+    return FAILURE;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  const off_t offset = (off_t)blockNum * BLOCK_SIZE;
+  ssize_t bytesRead = pread(fd, block, BLOCK_SIZE, offset);
+  stats.readNanos += nanosSince(start);
+  stats.reads++;
+
+  return bytesRead == BLOCK_SIZE ? SUCCESS : FAILURE;
 }
 
 /*
@@ -59,15 +271,121 @@ int Disk::readBlock(unsigned char *block, int blockNum) {
  * block - Memory pointer of the buffer to which contain the contents to be written.
  *         (MUST be Allocated by caller)
  * blockNum - Block number of the disk block to be written into.
+ * logged - Whether these contents are already in the write-ahead log, in which case they are not logged again.
  */
-int Disk::writeBlock(unsigned char *block, int blockNum) {
-  FILE *disk = fopen(DISK_RUN_COPY_PATH, "rb+");
+int Disk::writeBlock(unsigned char *block, int blockNum, bool logged) {
   if (blockNum < 0 || blockNum > DISK_BLOCKS - 1) {
     return E_OUTOFBOUND;
   }
-  const int offset = blockNum * BLOCK_SIZE;
-  fseek(disk, offset, SEEK_SET);
-  fwrite(block, BLOCK_SIZE, 1, disk);
-  fclose(disk);
-  return SUCCESS;
-}
\ No newline at end of file
+
+  markRunCopyDirty();
+  if (!logged && WriteAheadLog::logBlock(block, blockNum) != SUCCESS) {
+    return FAILURE;
+  }
+
+  if (mode == DISK_MODE_MMAP) {
+    std::memcpy(mappedDisk + (size_t)blockNum * BLOCK_SIZE, block, BLOCK_SIZE);
+    stats.writes++;
+    return SUCCESS;
+  }
+
+  int fd = openRunCopy();
+  if (fd == FAILURE) {
+    return FAILURE;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  const off_t offset = (off_t)blockNum * BLOCK_SIZE;
+  ssize_t bytesWritten = pwrite(fd, block, BLOCK_SIZE, offset);
+  stats.writeNanos += nanosSince(start);
+  stats.writes++;
+
+  return bytesWritten == BLOCK_SIZE ? SUCCESS : FAILURE;
+}
+
+/*
+ * Used to Write numBlocks consecutive blocks starting at blockNum with a single write
+ * blocks - Memory pointer of numBlocks * BLOCK_SIZE bytes holding the contents to be written.
+ * logged - Whether these contents are already in the write-ahead log, in which case they are not logged again.
+ */
+int Disk::writeBlocks(unsigned char *blocks, int blockNum, int numBlocks, bool logged) {
+  if (blockNum < 0 || numBlocks <= 0 || blockNum + numBlocks > DISK_BLOCKS) {
+    return E_OUTOFBOUND;
+  }
+
+  markRunCopyDirty();
+  for (int blockIndex = 0; blockIndex < numBlocks && !logged; blockIndex++) {
+    if (WriteAheadLog::logBlock(blocks + (size_t)blockIndex * BLOCK_SIZE, blockNum + blockIndex) != SUCCESS) {
+      return FAILURE;
+    }
+  }
+
+  const size_t length = (size_t)numBlocks * BLOCK_SIZE;
+  if (mode == DISK_MODE_MMAP) {
+    std::memcpy(mappedDisk + (size_t)blockNum * BLOCK_SIZE, blocks, length);
+    stats.writes += numBlocks;
+    return SUCCESS;
+  }
+
+  int fd = openRunCopy();
+  if (fd == FAILURE) {
+    return FAILURE;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  ssize_t bytesWritten = pwrite(fd, blocks, length, (off_t)blockNum * BLOCK_SIZE);
+  stats.writeNanos += nanosSince(start);
+  stats.writes += numBlocks;
+
+  return bytesWritten == (ssize_t)length ? SUCCESS : FAILURE;
+}
+
+/*
+ * Returns a pointer to the contents of the given block inside the mapped run copy.
+ * Returns nullptr if the disk is not in mmap mode or the block number is out of bounds.
+ * The pointer is only valid for reading, and only until the end of the session.
+ */
+const unsigned char *Disk::getMappedBlock(int blockNum) {
+  if (mode != DISK_MODE_MMAP || blockNum < 0 || blockNum > DISK_BLOCKS - 1) {
+    return nullptr;
+  }
+  return mappedDisk + (size_t)blockNum * BLOCK_SIZE;
+}
+
+/*
+ * Asks the kernel to start reading numBlocks blocks from blockNum onwards in the background,
+ * so that a later readBlock (or access through the mapping) finds them in the page cache.
+ */
+void Disk::prefetchBlocks(int blockNum, int numBlocks) {
+  if (blockNum < 0 || blockNum > DISK_BLOCKS - 1 || numBlocks <= 0) {
+    return;
+  }
+  if (blockNum + numBlocks > DISK_BLOCKS) {
+    numBlocks = DISK_BLOCKS - blockNum;
+  }
+
+  size_t offset = (size_t)blockNum * BLOCK_SIZE;
+  size_t length = (size_t)numBlocks * BLOCK_SIZE;
+  if (mode == DISK_MODE_MMAP) {
+    /* madvise needs a page aligned start */
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t alignedOffset = offset / pageSize * pageSize;
+    madvise(mappedDisk + alignedOffset, length + (offset - alignedOffset), MADV_WILLNEED);
+  } else if (runCopyFd != -1) {
+    posix_fadvise(runCopyFd, offset, length, POSIX_FADV_WILLNEED);
+  }
+}
+
+int Disk::getMode() {
+  return mode;
+}
+
+/*
+ * Copies the block I/O counters of the current session into statsBuf
+ */
+void Disk::getStats(struct DiskStats *statsBuf) {
+  statsBuf->reads = stats.reads;
+  statsBuf->writes = stats.writes;
+  statsBuf->readNanos = stats.readNanos;
+  statsBuf->writeNanos = stats.writeNanos;
+}
@@ -1,10 +1,70 @@
 #ifndef NITCBASE_H
 #define NITCBASE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "../define/constants.h"
+
+/* Counters for the block I/O served by the disk, latencies are in nanoseconds */
+struct DiskStats {
+  long long reads;
+  long long writes;
+  long long readNanos;
+  long long writeNanos;
+};
+
+/* The live counters behind DiskStats, atomic as both the foreground and the background writer do block I/O */
+struct DiskCounters {
+  std::atomic<long long> reads;
+  std::atomic<long long> writes;
+  std::atomic<long long> readNanos;
+  std::atomic<long long> writeNanos;
+};
+
+enum DiskMode {
+  DISK_MODE_PREAD = 0,  // blocks are copied in and out of the run copy with pread/pwrite
+  DISK_MODE_MMAP = 1    // the run copy is mapped into memory for the whole session
+};
+
+/* Identity of the disk file at the moment the run copy was last known to match it */
+struct DiskCleanMarker {
+  int64_t magic;
+  int64_t inode;
+  int64_t size;
+  int64_t mtimeSec;
+  int64_t mtimeNsec;
+};
+
 class Disk {
+ private:
+  // fields
+  static int runCopyFd;
+  static int mode;
+  static unsigned char *mappedDisk;
+  static struct DiskCounters stats;
+  static std::atomic<bool> runCopyClean;
+  static std::mutex writeLock;
+
+  // methods
+  static int openRunCopy();
+  static void closeRunCopy();
+  static int mapRunCopy();
+  static void unmapRunCopy();
+  static int getCleanMarker(struct DiskCleanMarker *marker);
+  static int writeCleanMarker();
+  static void markRunCopyDirty();
+
  public:
   Disk();
   ~Disk();
   static int readBlock(unsigned char *block, int blockNum);
-  static int writeBlock(unsigned char *block, int blockNum);
+  static int writeBlock(unsigned char *block, int blockNum, bool logged);
+  static int writeBlocks(unsigned char *blocks, int blockNum, int numBlocks, bool logged);
+  static const unsigned char *getMappedBlock(int blockNum);
+  static void prefetchBlocks(int blockNum, int numBlocks);
+  static int getMode();
+  static void getStats(struct DiskStats *statsBuf);
 };
-#endif  // NITCBASE_H
\ No newline at end of file
+#endif  // NITCBASE_H
@@ -0,0 +1,372 @@
+#include "WriteAheadLog.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+static const uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+static const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+int WriteAheadLog::logFd = -1;
+int WriteAheadLog::syncPolicy = WAL_SYNC_GROUP;
+int64_t WriteAheadLog::nextLsn = 0;
+int64_t WriteAheadLog::logSize = 0;
+int64_t WriteAheadLog::committedSize = 0;
+std::vector<unsigned char> WriteAheadLog::pending;
+uint64_t WriteAheadLog::uncommittedChecksum = FNV_OFFSET_BASIS;
+int64_t WriteAheadLog::uncommittedBlocks = 0;
+int WriteAheadLog::unsyncedCommits = 0;
+std::chrono::steady_clock::time_point WriteAheadLog::groupStart;
+std::mutex WriteAheadLog::logLock;
+std::mutex WriteAheadLog::checkpointLock;
+std::thread WriteAheadLog::syncer;
+std::condition_variable WriteAheadLog::syncerWake;
+bool WriteAheadLog::syncerStop = false;
+
+/* Folds len bytes into a running FNV-1a checksum */
+static uint64_t updateChecksum(uint64_t checksum, const void *data, size_t len) {
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < len; i++) {
+    checksum = (checksum ^ bytes[i]) * FNV_PRIME;
+  }
+  return checksum;
+}
+
+/*
+ * Recovers the disk from the log left by the previous session and opens the log for this session.
+ * The fsync policy is read from the WAL_SYNC_ENV environment variable, "group" being the default.
+ * Under group commit a background thread fsyncs a group once its window is over, even if no commit follows.
+ */
+int WriteAheadLog::open() {
+  const char *policy = std::getenv(WAL_SYNC_ENV);
+  if (policy != nullptr && std::strcmp(policy, "commit") == 0) {
+    syncPolicy = WAL_SYNC_COMMIT;
+  } else if (policy != nullptr && std::strcmp(policy, "none") == 0) {
+    syncPolicy = WAL_SYNC_NONE;
+  } else {
+    syncPolicy = WAL_SYNC_GROUP;
+  }
+
+  logFd = ::open(DISK_WAL_PATH, O_RDWR | O_CREAT, 0644);
+  if (logFd == -1) {
+    return FAILURE;
+  }
+
+  pending.reserve(WAL_BUFFER_SIZE + sizeof(struct WalRecordHeader) + BLOCK_SIZE);
+  int ret = checkpoint();
+
+  if (ret == SUCCESS && syncPolicy == WAL_SYNC_GROUP) {
+    syncerStop = false;
+    syncer = std::thread(syncLoop);
+  }
+  return ret;
+}
+
+/*
+ * Commits whatever was logged last and checkpoints the log into the disk.
+ * On success the disk holds every block written during the session.
+ */
+int WriteAheadLog::close() {
+  if (logFd == -1) {
+    return FAILURE;
+  }
+
+  if (syncer.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(logLock);
+      syncerStop = true;
+    }
+    syncerWake.notify_one();
+    syncer.join();
+  }
+
+  int ret = commit();
+  if (ret == SUCCESS) {
+    ret = checkpoint();
+  }
+
+  ::close(logFd);
+  logFd = -1;
+  return ret;
+}
+
+/*
+ * Appends the after-image of a block to the log.
+ * The record only survives a crash once a later commit has been made durable.
+ * Without an open log nothing is recorded, and the session relies on the full copy at shutdown.
+ */
+int WriteAheadLog::logBlock(const unsigned char *block, int blockNum) {
+  std::lock_guard<std::mutex> guard(logLock);
+  if (logFd == -1) {
+    return SUCCESS;
+  }
+
+  struct WalRecordHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.type = WAL_BLOCK;
+  header.blockNum = blockNum;
+  header.lsn = nextLsn++;
+
+  uncommittedChecksum = updateChecksum(uncommittedChecksum, &header, sizeof(header));
+  uncommittedChecksum = updateChecksum(uncommittedChecksum, block, BLOCK_SIZE);
+  uncommittedBlocks++;
+
+  pending.insert(pending.end(), (const unsigned char *)&header, (const unsigned char *)&header + sizeof(header));
+  pending.insert(pending.end(), block, block + BLOCK_SIZE);
+
+  if (pending.size() >= WAL_BUFFER_SIZE) {
+    return flush(false);
+  }
+  return SUCCESS;
+}
+
+/*
+ * Marks the end of a unit of work (one frontend statement).
+ * Depending on the fsync policy the commit is made durable now, together with the rest of its group,
+ * or left to the operating system. A group is fsync'ed once it has WAL_GROUP_COMMITS commits, or by
+ * the syncer thread WAL_GROUP_WINDOW_MS after its first commit.
+ * The log is checkpointed once it grows past WAL_CHECKPOINT_SIZE.
+ */
+int WriteAheadLog::commit() {
+  std::unique_lock<std::mutex> lock(logLock);
+  if (logFd == -1) {
+    return SUCCESS;
+  }
+
+  if (uncommittedBlocks > 0) {
+    struct WalRecordHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.type = WAL_COMMIT;
+    header.blockNum = INVALID_BLOCKNUM;
+    header.lsn = nextLsn++;
+    header.checksum = uncommittedChecksum;
+    header.numBlocks = uncommittedBlocks;
+    pending.insert(pending.end(), (const unsigned char *)&header, (const unsigned char *)&header + sizeof(header));
+    committedSize = logSize + (int64_t)pending.size();
+
+    uncommittedChecksum = FNV_OFFSET_BASIS;
+    uncommittedBlocks = 0;
+    if (unsyncedCommits++ == 0) {
+      groupStart = std::chrono::steady_clock::now();
+      syncerWake.notify_one();
+    }
+  }
+
+  /* A statement that wrote nothing still closes the window of an earlier group */
+  if (unsyncedCommits == 0) {
+    return SUCCESS;
+  }
+
+  int ret = SUCCESS;
+  if (syncPolicy == WAL_SYNC_COMMIT) {
+    ret = flush(true);
+  } else if (syncPolicy == WAL_SYNC_GROUP) {
+    auto waited = std::chrono::steady_clock::now() - groupStart;
+    if (unsyncedCommits >= WAL_GROUP_COMMITS || waited >= std::chrono::milliseconds(WAL_GROUP_WINDOW_MS)) {
+      ret = flush(true);
+    }
+  } else if (pending.size() >= WAL_BUFFER_SIZE) {
+    ret = flush(false);
+  }
+
+  if (ret == SUCCESS && logSize + (int64_t)pending.size() >= WAL_CHECKPOINT_SIZE) {
+    lock.unlock();
+    ret = checkpoint();
+    /* Records logged in the meantime put the checkpoint off until a later commit */
+    if (ret == E_NOTPERMITTED) {
+      ret = SUCCESS;
+    }
+  }
+  return ret;
+}
+
+/*
+ * Drops the block records logged since the last commit, for a unit of work that is rolled back.
+ * Records already written to the log file are cut off with it.
+ */
+int WriteAheadLog::rollback() {
+  std::lock_guard<std::mutex> guard(logLock);
+  if (logFd == -1) {
+    return SUCCESS;
+  }
+
+  uncommittedChecksum = FNV_OFFSET_BASIS;
+  uncommittedBlocks = 0;
+  if (committedSize >= logSize) {
+    pending.resize(committedSize - logSize);
+    return SUCCESS;
+  }
+
+  pending.clear();
+  if (ftruncate(logFd, committedSize) != 0) {
+    return FAILURE;
+  }
+  logSize = committedSize;
+  return SUCCESS;
+}
+
+/*
+ * Body of the syncer thread. Sleeps until a group has its first commit, then fsyncs the group
+ * when its window is over unless a later commit already did.
+ */
+void WriteAheadLog::syncLoop() {
+  std::unique_lock<std::mutex> lock(logLock);
+
+  while (!syncerStop) {
+    if (unsyncedCommits == 0) {
+      syncerWake.wait(lock);
+      continue;
+    }
+
+    auto deadline = groupStart + std::chrono::milliseconds(WAL_GROUP_WINDOW_MS);
+    if (std::chrono::steady_clock::now() < deadline) {
+      syncerWake.wait_until(lock, deadline);
+    } else if (flush(true) != SUCCESS) {
+      /* Retried after another window */
+      groupStart = std::chrono::steady_clock::now();
+    }
+  }
+}
+
+/*
+ * Copies every committed block image in the log into the disk and empties the log.
+ * Returns E_NOTPERMITTED without touching the log if block records were logged after the last commit,
+ * since emptying the log would lose them.
+ * The log is replayed without holding logLock, so commits can go on meanwhile. Records they append are
+ * kept, and the log is then only emptied by a later checkpoint (replaying an image twice is harmless),
+ * so E_NOTPERMITTED is returned in that case as well.
+ */
+int WriteAheadLog::checkpoint() {
+  std::lock_guard<std::mutex> checkpointGuard(checkpointLock);
+  std::unique_lock<std::mutex> lock(logLock);
+  if (logFd == -1) {
+    return FAILURE;
+  }
+  if (uncommittedBlocks > 0) {
+    return E_NOTPERMITTED;
+  }
+
+  int ret = flush(true);
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  /* A log left by an earlier session can be longer than what this session has written */
+  struct stat logStat;
+  if (fstat(logFd, &logStat) != 0) {
+    return FAILURE;
+  }
+  int64_t replayedSize = logSize;
+
+  lock.unlock();
+  ret = replay(logStat.st_size);
+  lock.lock();
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  if (logSize != replayedSize) {
+    return E_NOTPERMITTED;
+  }
+  if (ftruncate(logFd, 0) != 0 || fsync(logFd) != 0) {
+    return FAILURE;
+  }
+  logSize = 0;
+  committedSize = 0;
+  return SUCCESS;
+}
+
+/*
+ * Writes the buffered records to the end of the log, and fsyncs the log if sync is set.
+ * The caller must hold logLock.
+ */
+int WriteAheadLog::flush(bool sync) {
+  size_t written = 0;
+  while (written < pending.size()) {
+    ssize_t ret = pwrite(logFd, pending.data() + written, pending.size() - written, logSize + written);
+    if (ret <= 0) {
+      return FAILURE;
+    }
+    written += ret;
+  }
+  logSize += written;
+  pending.clear();
+
+  if (sync) {
+    if (unsyncedCommits > 0 && fdatasync(logFd) != 0) {
+      return FAILURE;
+    }
+    unsyncedCommits = 0;
+  }
+  return SUCCESS;
+}
+
+/*
+ * Applies the block records of every complete, intact commit in the first replaySize bytes of the log
+ * to the disk, in log order.
+ * Scanning stops at the first torn or corrupt record, which can only follow the last durable commit.
+ */
+int WriteAheadLog::replay(int64_t replaySize) {
+  if (replaySize == 0) {
+    return SUCCESS;
+  }
+
+  int diskFd = ::open(DISK_PATH, O_WRONLY);
+  if (diskFd == -1) {
+    return FAILURE;
+  }
+
+  const off_t recordSize = sizeof(struct WalRecordHeader) + BLOCK_SIZE;
+  unsigned char block[BLOCK_SIZE];
+  struct WalRecordHeader header;
+  off_t commitStart = 0, offset = 0;
+  uint64_t checksum = FNV_OFFSET_BASIS;
+  int64_t numBlocks = 0;
+  int ret = SUCCESS;
+
+  while (ret == SUCCESS && offset + (off_t)sizeof(header) <= replaySize) {
+    if (pread(logFd, &header, sizeof(header), offset) != sizeof(header)) {
+      break;
+    }
+
+    if (header.type == WAL_BLOCK) {
+      if (offset + recordSize > replaySize ||
+          pread(logFd, block, BLOCK_SIZE, offset + sizeof(header)) != BLOCK_SIZE) {
+        break;
+      }
+      checksum = updateChecksum(checksum, &header, sizeof(header));
+      checksum = updateChecksum(checksum, block, BLOCK_SIZE);
+      numBlocks++;
+      offset += recordSize;
+      continue;
+    }
+
+    if (header.type != WAL_COMMIT || header.checksum != checksum || header.numBlocks != numBlocks) {
+      break;
+    }
+
+    /* The commit is intact, so its block records can be applied */
+    for (off_t blockOffset = commitStart; blockOffset < offset; blockOffset += recordSize) {
+      if (pread(logFd, &header, sizeof(header), blockOffset) != sizeof(header) ||
+          pread(logFd, block, BLOCK_SIZE, blockOffset + sizeof(header)) != BLOCK_SIZE ||
+          header.blockNum < 0 || header.blockNum > DISK_BLOCKS - 1 ||
+          pwrite(diskFd, block, BLOCK_SIZE, (off_t)header.blockNum * BLOCK_SIZE) != BLOCK_SIZE) {
+        ret = FAILURE;
+        break;
+      }
+    }
+    offset += sizeof(header);
+    commitStart = offset;
+    checksum = FNV_OFFSET_BASIS;
+    numBlocks = 0;
+  }
+
+  if (fsync(diskFd) != 0) {
+    ret = FAILURE;
+  }
+  ::close(diskFd);
+  return ret;
+}
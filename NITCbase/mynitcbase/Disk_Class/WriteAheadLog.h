@@ -0,0 +1,65 @@
+#ifndef NITCBASE_WRITEAHEADLOG_H
+#define NITCBASE_WRITEAHEADLOG_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../define/constants.h"
+
+enum WalRecordType {
+  WAL_BLOCK = 1,  // after-image of a block, followed by BLOCK_SIZE bytes
+  WAL_COMMIT = 2  // makes every block record since the previous commit durable
+};
+
+enum WalSyncPolicy {
+  WAL_SYNC_COMMIT = 0,  // every commit is fsync'ed before it returns
+  WAL_SYNC_GROUP = 1,   // up to WAL_GROUP_COMMITS commits share one write and one fsync
+  WAL_SYNC_NONE = 2     // the log is written but never fsync'ed, only a process crash is survived
+};
+
+struct WalRecordHeader {
+  int32_t type;
+  int32_t blockNum;
+  int64_t lsn;
+  uint64_t checksum;  // for a commit, checksum of the block records since the previous commit
+  int64_t numBlocks;  // for a commit, number of block records since the previous commit
+};
+
+class WriteAheadLog {
+ private:
+  // fields
+  static int logFd;
+  static int syncPolicy;
+  static int64_t nextLsn;
+  static int64_t logSize;
+  static int64_t committedSize;
+  static std::vector<unsigned char> pending;
+  static uint64_t uncommittedChecksum;
+  static int64_t uncommittedBlocks;
+  static int unsyncedCommits;
+  static std::chrono::steady_clock::time_point groupStart;
+  static std::mutex logLock;
+  static std::mutex checkpointLock;
+  static std::thread syncer;
+  static std::condition_variable syncerWake;
+  static bool syncerStop;
+
+  // methods
+  static int flush(bool sync);
+  static int replay(int64_t replaySize);
+  static void syncLoop();
+
+ public:
+  static int open();
+  static int close();
+  static int logBlock(const unsigned char *block, int blockNum);
+  static int commit();
+  static int rollback();
+  static int checkpoint();
+};
+
+#endif  // NITCBASE_WRITEAHEADLOG_H
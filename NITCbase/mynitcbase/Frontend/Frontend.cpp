@@ -45,11 +45,34 @@ int Frontend::drop_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]) {
   return SUCCESS;
 }
 
+int Frontend::create_composite_index(char relname[ATTR_SIZE], int attr_count, char attr_list[][ATTR_SIZE]) {
+  // Schema::createIndex (composite)
+  return SUCCESS;
+}
+
+int Frontend::drop_composite_index(char relname[ATTR_SIZE], int attr_count, char attr_list[][ATTR_SIZE]) {
+  // Schema::dropIndex (composite)
+  return SUCCESS;
+}
+
 int Frontend::insert_into_table_values(char relname[ATTR_SIZE], int attr_count, char attr_values[][ATTR_SIZE]) {
   // Algebra::insert
   return SUCCESS;
 }
 
+int Frontend::delete_from_table_where(char relname[ATTR_SIZE], int cond_count, char attributes[][ATTR_SIZE], int ops[],
+                                      char values[][ATTR_SIZE]) {
+  // Algebra::deleteRecords (all records if cond_count is 0)
+  return SUCCESS;
+}
+
+int Frontend::update_table_set_where(char relname[ATTR_SIZE], int set_count, char set_attributes[][ATTR_SIZE],
+                                     char set_values[][ATTR_SIZE], int cond_count, char attributes[][ATTR_SIZE],
+                                     int ops[], char values[][ATTR_SIZE]) {
+  // Algebra::updateRecords (all records if cond_count is 0)
+  return SUCCESS;
+}
+
 int Frontend::select_from_table(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE]) {
   // Algebra::project
   return SUCCESS;
@@ -74,6 +97,21 @@ int Frontend::select_attrlist_from_table_where(char relname_source[ATTR_SIZE], c
   return SUCCESS;
 }
 
+int Frontend::select_from_table_where_and(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
+                                          int cond_count, char attributes[][ATTR_SIZE], int ops[],
+                                          char values[][ATTR_SIZE]) {
+  // Algebra::select (all conditions)
+  return SUCCESS;
+}
+
+int Frontend::select_attrlist_from_table_where_and(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
+                                                   int attr_count, char attr_list[][ATTR_SIZE],
+                                                   int cond_count, char attributes[][ATTR_SIZE], int ops[],
+                                                   char values[][ATTR_SIZE]) {
+  // Algebra::select (all conditions) into a temporary relation + Algebra::project + drop the temporary relation
+  return SUCCESS;
+}
+
 int Frontend::select_from_join_where(char relname_source_one[ATTR_SIZE], char relname_source_two[ATTR_SIZE],
                                      char relname_target[ATTR_SIZE],
                                      char join_attr_one[ATTR_SIZE], char join_attr_two[ATTR_SIZE]) {
@@ -89,6 +127,11 @@ int Frontend::select_attrlist_from_join_where(char relname_source_one[ATTR_SIZE]
   return SUCCESS;
 }
 
+int Frontend::order_by(char relname[ATTR_SIZE], char attribute[ATTR_SIZE], int order) {
+  // Algebra::sort into a temporary relation + drop relname + rename the temporary relation to relname
+  return SUCCESS;
+}
+
 int Frontend::custom_function(int argc, char argv[][ATTR_SIZE]) {
   // argc gives the size of the argv array
   // argv stores every token delimited by space and comma
@@ -20,6 +20,10 @@ class Frontend {
 
   static int drop_index(char relname[ATTR_SIZE], char attrname[ATTR_SIZE]);
 
+  static int create_composite_index(char relname[ATTR_SIZE], int attr_count, char attr_list[][ATTR_SIZE]);
+
+  static int drop_composite_index(char relname[ATTR_SIZE], int attr_count, char attr_list[][ATTR_SIZE]);
+
   static int alter_table_rename(char relname_from[ATTR_SIZE], char relname_to[ATTR_SIZE]);
 
   static int alter_table_rename_column(char relname[ATTR_SIZE], char attrname_from[16], char attrname_to[16]);
@@ -27,6 +31,13 @@ class Frontend {
   // DML
   static int insert_into_table_values(char relname[ATTR_SIZE], int attr_count, char attr_values[][ATTR_SIZE]);
 
+  static int delete_from_table_where(char relname[ATTR_SIZE], int cond_count, char attributes[][ATTR_SIZE], int ops[],
+                                     char values[][ATTR_SIZE]);
+
+  static int update_table_set_where(char relname[ATTR_SIZE], int set_count, char set_attributes[][ATTR_SIZE],
+                                    char set_values[][ATTR_SIZE], int cond_count, char attributes[][ATTR_SIZE],
+                                    int ops[], char values[][ATTR_SIZE]);
+
   static int select_from_table(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE]);
 
   static int select_attrlist_from_table(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
@@ -39,6 +50,15 @@ class Frontend {
                                               int attr_count, char attr_list[][ATTR_SIZE],
                                               char attribute[ATTR_SIZE], int op, char value[ATTR_SIZE]);
 
+  static int select_from_table_where_and(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
+                                         int cond_count, char attributes[][ATTR_SIZE], int ops[],
+                                         char values[][ATTR_SIZE]);
+
+  static int select_attrlist_from_table_where_and(char relname_source[ATTR_SIZE], char relname_target[ATTR_SIZE],
+                                                  int attr_count, char attr_list[][ATTR_SIZE],
+                                                  int cond_count, char attributes[][ATTR_SIZE], int ops[],
+                                                  char values[][ATTR_SIZE]);
+
   static int select_from_join_where(char relname_source_one[ATTR_SIZE], char relname_source_two[ATTR_SIZE],
                                     char relname_target[ATTR_SIZE],
                                     char join_attr_one[ATTR_SIZE], char join_attr_two[ATTR_SIZE]);
@@ -48,6 +68,8 @@ class Frontend {
                                              char join_attr_one[ATTR_SIZE], char join_attr_two[ATTR_SIZE],
                                              int attr_count, char attr_list[][ATTR_SIZE]);
 
+  static int order_by(char relname[ATTR_SIZE], char attribute[ATTR_SIZE], int order);
+
   static int custom_function(int argc, char argv[][ATTR_SIZE]);
 };
 
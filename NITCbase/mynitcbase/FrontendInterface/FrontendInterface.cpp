@@ -9,6 +9,7 @@
 
 #include "FrontendInterface.h"
 
+#include "../Buffer/StaticBuffer.h"
 #include "../Disk_Class/Disk.h"
 #include "../Frontend/Frontend.h"
 #include "../define/constants.h"
@@ -31,6 +32,16 @@ vector<string> RegexHandler::extractTokens(string input) {
   return tokens;
 }
 
+// extract the attribute, operator and value of every condition of an AND-ed WHERE clause
+void RegexHandler::extractConditions(string input, vector<string> &attrs, vector<string> &ops, vector<string> &values) {
+  regex re(WHERE_CONDITION);
+  for (sregex_iterator iter(input.begin(), input.end(), re), last; iter != last; ++iter) {
+    attrs.push_back((*iter)[1]);
+    ops.push_back((*iter)[2]);
+    values.push_back((*iter)[3]);
+  }
+}
+
 // handler functions
 int RegexHandler::helpHandler() {
   printHelp();
@@ -168,6 +179,54 @@ int RegexHandler::dropIndexHandler() {
   return ret;
 }
 
+int RegexHandler::createCompositeIndexHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  vector<string> words = extractTokens(m[2]);
+  int attrCount = words.size();
+  if (attrCount > COMPOSITE_INDEX_MAX_ATTRS) {
+    cout << "A composite index can have at most " << COMPOSITE_INDEX_MAX_ATTRS << " attributes\n";
+    return FAILURE;
+  }
+
+  char attrNames[attrCount][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(words[i], attrNames[i]);
+  }
+
+  int ret = Frontend::create_composite_index(relName, attrCount, attrNames);
+  if (ret == SUCCESS) {
+    cout << "Index created successfully\n";
+  }
+
+  return ret;
+}
+
+int RegexHandler::dropCompositeIndexHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  vector<string> words = extractTokens(m[2]);
+  int attrCount = words.size();
+  if (attrCount > COMPOSITE_INDEX_MAX_ATTRS) {
+    cout << "A composite index can have at most " << COMPOSITE_INDEX_MAX_ATTRS << " attributes\n";
+    return FAILURE;
+  }
+
+  char attrNames[attrCount][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(words[i], attrNames[i]);
+  }
+
+  int ret = Frontend::drop_composite_index(relName, attrCount, attrNames);
+  if (ret == SUCCESS) {
+    cout << "Index deleted successfully\n";
+  }
+
+  return ret;
+}
+
 int RegexHandler::renameTableHandler() {
   char oldRelName[ATTR_SIZE];
   char newRelName[ATTR_SIZE];
@@ -294,6 +353,71 @@ int RegexHandler::insertFromFileHandler() {
   return retVal;
 }
 
+int RegexHandler::deleteFromHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  // without a WHERE clause, every record is deleted
+  vector<string> attrTokens, opTokens, valueTokens;
+  extractConditions(m[2], attrTokens, opTokens, valueTokens);
+
+  int condCount = attrTokens.size();
+  char attributes[condCount + 1][ATTR_SIZE];
+  int ops[condCount + 1];
+  char values[condCount + 1][ATTR_SIZE];
+  for (int i = 0; i < condCount; i++) {
+    attrToTruncatedArray(attrTokens[i], attributes[i]);
+    ops[i] = getOperator(opTokens[i]);
+    attrToTruncatedArray(valueTokens[i], values[i]);
+  }
+
+  int ret = Frontend::delete_from_table_where(relName, condCount, attributes, ops, values);
+  if (ret == SUCCESS) {
+    cout << "Deleted successfully from " << relName << endl;
+  }
+
+  return ret;
+}
+
+int RegexHandler::updateSetHandler() {
+  char relName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], relName);
+
+  // the assignments of the SET clause are split like conditions with '='
+  vector<string> setAttrTokens, setOpTokens, setValueTokens;
+  extractConditions(m[2], setAttrTokens, setOpTokens, setValueTokens);
+
+  int setCount = setAttrTokens.size();
+  char setAttributes[setCount][ATTR_SIZE];
+  char setValues[setCount][ATTR_SIZE];
+  for (int i = 0; i < setCount; i++) {
+    attrToTruncatedArray(setAttrTokens[i], setAttributes[i]);
+    attrToTruncatedArray(setValueTokens[i], setValues[i]);
+  }
+
+  // without a WHERE clause, every record is updated
+  vector<string> attrTokens, opTokens, valueTokens;
+  extractConditions(m[3], attrTokens, opTokens, valueTokens);
+
+  int condCount = attrTokens.size();
+  char attributes[condCount + 1][ATTR_SIZE];
+  int ops[condCount + 1];
+  char values[condCount + 1][ATTR_SIZE];
+  for (int i = 0; i < condCount; i++) {
+    attrToTruncatedArray(attrTokens[i], attributes[i]);
+    ops[i] = getOperator(opTokens[i]);
+    attrToTruncatedArray(valueTokens[i], values[i]);
+  }
+
+  int ret = Frontend::update_table_set_where(relName, setCount, setAttributes, setValues, condCount, attributes, ops,
+                                             values);
+  if (ret == SUCCESS) {
+    cout << "Updated successfully in " << relName << endl;
+  }
+
+  return ret;
+}
+
 int RegexHandler::selectFromHandler() {
   char sourceRelName[ATTR_SIZE];
   char targetRelName[ATTR_SIZE];
@@ -378,6 +502,68 @@ int RegexHandler::selectAttrFromWhereHandler() {
   return ret;
 }
 
+int RegexHandler::selectFromWhereAndHandler() {
+  char sourceRelName[ATTR_SIZE];
+  char targetRelName[ATTR_SIZE];
+  attrToTruncatedArray(m[1], sourceRelName);
+  attrToTruncatedArray(m[2], targetRelName);
+
+  vector<string> attrTokens, opTokens, valueTokens;
+  extractConditions(m[3], attrTokens, opTokens, valueTokens);
+
+  int condCount = attrTokens.size();
+  char attributes[condCount][ATTR_SIZE];
+  int ops[condCount];
+  char values[condCount][ATTR_SIZE];
+  for (int i = 0; i < condCount; i++) {
+    attrToTruncatedArray(attrTokens[i], attributes[i]);
+    ops[i] = getOperator(opTokens[i]);
+    attrToTruncatedArray(valueTokens[i], values[i]);
+  }
+
+  int ret = Frontend::select_from_table_where_and(sourceRelName, targetRelName, condCount, attributes, ops, values);
+  if (ret == SUCCESS) {
+    cout << "Selected successfully into " << targetRelName << endl;
+  }
+
+  return ret;
+}
+
+int RegexHandler::selectAttrFromWhereAndHandler() {
+  char sourceRelName[ATTR_SIZE];
+  char targetRelName[ATTR_SIZE];
+  attrToTruncatedArray(m[2], sourceRelName);
+  attrToTruncatedArray(m[3], targetRelName);
+
+  vector<string> attrListTokens = extractTokens(m[1]);
+  int attrCount = attrListTokens.size();
+  char attrNames[attrCount][ATTR_SIZE];
+  for (int i = 0; i < attrCount; i++) {
+    attrToTruncatedArray(attrListTokens[i], attrNames[i]);
+  }
+
+  vector<string> attrTokens, opTokens, valueTokens;
+  extractConditions(m[4], attrTokens, opTokens, valueTokens);
+
+  int condCount = attrTokens.size();
+  char attributes[condCount][ATTR_SIZE];
+  int ops[condCount];
+  char values[condCount][ATTR_SIZE];
+  for (int i = 0; i < condCount; i++) {
+    attrToTruncatedArray(attrTokens[i], attributes[i]);
+    ops[i] = getOperator(opTokens[i]);
+    attrToTruncatedArray(valueTokens[i], values[i]);
+  }
+
+  int ret = Frontend::select_attrlist_from_table_where_and(sourceRelName, targetRelName, attrCount, attrNames,
+                                                           condCount, attributes, ops, values);
+  if (ret == SUCCESS) {
+    cout << "Selected successfully into " << targetRelName << endl;
+  }
+
+  return ret;
+}
+
 int RegexHandler::selectFromJoinHandler() {
   char sourceRelOneName[ATTR_SIZE];
   char sourceRelTwoName[ATTR_SIZE];
@@ -452,6 +638,38 @@ int RegexHandler::selectAttrFromJoinHandler() {
   return ret;
 }
 
+int RegexHandler::selectOrderByHandler() {
+  string selectCommand = m[1];
+  char relName[ATTR_SIZE];
+  char attribute[ATTR_SIZE];
+  attrToTruncatedArray(m[2], attribute);
+  int order = (m[3].length() > 0 && toupper(m[3].str()[0]) == 'D') ? DESC : ASC;
+
+  // run the select without the ORDER BY clause, then sort the relation it created
+  int ret = FAILURE;
+  for (auto iter = handlers.begin(); iter != handlers.end(); ++iter) {
+    if (iter->second != &RegexHandler::selectOrderByHandler && regex_match(selectCommand, iter->first)) {
+      regex_search(selectCommand, m, iter->first);
+      ret = (this->*(iter->second))();
+      break;
+    }
+  }
+  if (ret != SUCCESS) {
+    return ret;
+  }
+
+  smatch target;
+  regex_search(selectCommand, target, REGEX("\\s+INTO\\s+([A-Za-z0-9_-]+)"));
+  attrToTruncatedArray(target[1], relName);
+
+  ret = Frontend::order_by(relName, attribute, order);
+  if (ret == SUCCESS) {
+    cout << "Sorted " << relName << " on " << attribute << endl;
+  }
+
+  return ret;
+}
+
 int RegexHandler::customFunctionHandler() {
   vector<string> tokens = extractTokens(m[1]);
 
@@ -471,9 +689,12 @@ int RegexHandler::handle(const string command) {
     if (regex_match(command, testCommand)) {
       regex_search(command, m, testCommand);
       int status = (this->*handler)();
+      /* The changes of a statement are only made durable if it succeeded */
       if (status == SUCCESS || status == EXIT) {
+        StaticBuffer::commit();
         return status;
       }
+      StaticBuffer::rollback();
       printErrorMsg(status);
       return FAILURE;
     }
@@ -590,16 +811,22 @@ void printHelp() {
   printf("CLOSE TABLE tablename;\n\t-close the relation \n \n");
   printf("CREATE INDEX ON tablename.attributename;\n\t-create an index on a given attribute. \n\n");
   printf("DROP INDEX ON tablename.attributename; \n\t-delete the index. \n\n");
+  printf("CREATE INDEX ON tablename(attr1, attr2, ...);\n\t-create a composite index on up to 4 attributes, in the given order. \n\n");
+  printf("DROP INDEX ON tablename(attr1, attr2, ...); \n\t-delete the composite index. \n\n");
   printf("ALTER TABLE RENAME tablename TO new_tablename;\n\t-rename an existing relation to a given new name. \n\n");
   printf("ALTER TABLE RENAME tablename COLUMN column_name TO new_column_name;\n\t-rename an attribute of an existing relation.\n\n");
   printf("INSERT INTO tablename VALUES ( value1,value2,value3,... );\n\t-insert a single record into the given relation. \n\n");
   printf("INSERT INTO tablename VALUES FROM filepath; \n\t-insert multiple records from a csv file \n\n");
+  printf("DELETE FROM tablename [WHERE attr1 OP value1 AND attr2 OP value2 ...]; \n\t-delete the records satisfying all the given conditions, or every record of the relation \n\n");
+  printf("UPDATE tablename SET attr1 = value1, attr2 = value2 ... [WHERE attr1 OP value1 AND ...]; \n\t-set the attributes of the records satisfying all the given conditions, or of every record of the relation \n\n");
   printf("SELECT * FROM source_relation INTO target_relation; \n\t-creates a relation with the same attributes and records as of source relation\n\n");
   printf("SELECT Attribute1,Attribute2,....FROM source_relation INTO target_relation; \n\t-creates a relation with attributes specified and all records\n\n");
   printf("SELECT * FROM source_relation INTO target_relation WHERE attrname OP value; \n\t-retrieve records based on a condition and insert them into a target relation\n\n");
   printf("SELECT Attribute1,Attribute2,....FROM source_relation INTO target_relation;\n\t-creates a relation with the attributes specified and inserts those records which satisfy the given condition.\n\n");
+  printf("SELECT ... INTO target_relation WHERE attr1 OP value1 AND attr2 OP value2 ...; \n\t-either of the two SELECT commands above, inserting the records which satisfy all the given conditions\n\n");
   printf("SELECT * FROM source_relation1 JOIN source_relation2 INTO target_relation WHERE source_relation1.attribute1 = source_relation2.attribute2; \n\t-creates a new relation with by equi-join of both the source relations\n\n");
   printf("SELECT Attribute1,Attribute2,.. FROM source_relation1 JOIN source_relation2 INTO target_relation WHERE source_relation1.attribute1 = source_relation2.attribute2; \n\t-creates a new relation by equi-join of both the source relations with the attributes specified \n\n");
+  printf("SELECT ... INTO target_relation ... ORDER BY attrname [ASC|DESC]; \n\t-any of the above SELECT commands, with the records of the target relation sorted on the given attribute (ascending by default)\n\n");
   printf("echo <any message> \n\t  -echo back the given string. \n\n");
   printf("run <filename> \n\t  -run commands from an input file in sequence. \n\n");
   printf("exit \n\t-Exit the interface\n");
@@ -18,6 +18,8 @@
 #define CLOSE_TABLE_CMD "\\s*CLOSE\\s+TABLE\\s+([A-Za-z0-9_-]+)\\s*;?"
 #define CREATE_INDEX_CMD "\\s*CREATE\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*([#A-Za-z0-9_-]+)\\s*;?"
 #define DROP_INDEX_CMD "\\s*DROP\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\.\\s*([#A-Za-z0-9_-]+)\\s*;?"
+#define CREATE_COMPOSITE_INDEX_CMD "\\s*CREATE\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\(\\s*((?:[#A-Za-z0-9_-]+\\s*,\\s*)+(?:[#A-Za-z0-9_-]+))\\s*\\)\\s*;?"
+#define DROP_COMPOSITE_INDEX_CMD "\\s*DROP\\s+INDEX\\s+ON\\s+([A-Za-z0-9_-]+)\\s*\\(\\s*((?:[#A-Za-z0-9_-]+\\s*,\\s*)+(?:[#A-Za-z0-9_-]+))\\s*\\)\\s*;?"
 #define RENAME_TABLE_CMD "\\s*ALTER\\s+TABLE\\s+RENAME\\s+([a-zA-Z0-9_-]+)\\s+TO\\s+([a-zA-Z0-9_-]+)\\s*;?"
 #define RENAME_COLUMN_CMD "\\s*ALTER\\s+TABLE\\s+RENAME\\s+([a-zA-Z0-9_-]+)\\s+COLUMN\\s+([#a-zA-Z0-9_-]+)\\s+TO\\s+([#a-zA-Z0-9_-]+)\\s*;?"
 
@@ -26,10 +28,16 @@
 #define SELECT_ATTR_FROM_CMD "\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s*;?"
 #define SELECT_FROM_WHERE_CMD "\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([#A-Za-z0-9_-]+)\\s*(<|<=|>|>=|=|!=)\\s*([A-Za-z0-9_-]+|([0-9]+(\\.)[0-9]+))\\s*;?"
 #define SELECT_ATTR_FROM_WHERE_CMD "\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([#A-Za-z0-9_-]+)\\s*(<|<=|>|>=|=|!=)\\s*([A-Za-z0-9_-]+|([0-9]+(\\.)[0-9]+))\\s*;?"
+#define WHERE_CONDITION "([#A-Za-z0-9_-]+)\\s*(<=|>=|!=|<|>|=)\\s*([0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)"
+#define SELECT_FROM_WHERE_AND_CMD "\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+((?:[#A-Za-z0-9_-]+\\s*(?:<=|>=|!=|<|>|=)\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)\\s+AND\\s+)+[#A-Za-z0-9_-]+\\s*(?:<=|>=|!=|<|>|=)\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+))\\s*;?"
+#define SELECT_ATTR_FROM_WHERE_AND_CMD "\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+((?:[#A-Za-z0-9_-]+\\s*(?:<=|>=|!=|<|>|=)\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)\\s+AND\\s+)+[#A-Za-z0-9_-]+\\s*(?:<=|>=|!=|<|>|=)\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+))\\s*;?"
 #define SELECT_FROM_JOIN_CMD "\\s*SELECT\\s+\\*\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+JOIN\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*\\=\\s*([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*;?"
 #define SELECT_ATTR_FROM_JOIN_CMD "\\s*SELECT\\s+((?:[#A-Za-z0-9_-]+\\s*,\\s*)*(?:[#A-Za-z0-9_-]+))\\s+FROM\\s+([A-Za-z0-9_-]+)\\s+JOIN\\s+([A-Za-z0-9_-]+)\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+WHERE\\s+([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*\\=\\s*([A-Za-z0-9_-]+)\\s*\\.([#A-Za-z0-9_-]+)\\s*;?"
+#define SELECT_ORDER_BY_CMD "(\\s*SELECT\\s+.+?\\s+INTO\\s+[A-Za-z0-9_-]+.*?)\\s+ORDER\\s+BY\\s+([#A-Za-z0-9_-]+)(?:\\s+(ASC|DESC))?\\s*;?"
 #define INSERT_SINGLE_CMD "\\s*INSERT\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+VALUES\\s*\\(\\s*((?:(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+)\\s*,\\s*)*(?:[A-Za-z0-9_-]+|[0-9]+\\.[0-9]+))\\s*\\)\\s*;?"
 #define INSERT_MULTIPLE_CMD "\\s*INSERT\\s+INTO\\s+([A-Za-z0-9_-]+)\\s+VALUES\\s+FROM\\s+([a-zA-Z0-9_-]+\\.csv)\\s*;?"
+#define DELETE_FROM_CMD "\\s*DELETE\\s+FROM\\s+([A-Za-z0-9_-]+)(?:\\s+WHERE\\s+((?:[#A-Za-z0-9_-]+\\s*(?:<=|>=|!=|<|>|=)\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)\\s+AND\\s+)*[#A-Za-z0-9_-]+\\s*(?:<=|>=|!=|<|>|=)\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)))?\\s*;?"
+#define UPDATE_SET_CMD "\\s*UPDATE\\s+([A-Za-z0-9_-]+)\\s+SET\\s+((?:[#A-Za-z0-9_-]+\\s*=\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)\\s*,\\s*)*[#A-Za-z0-9_-]+\\s*=\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+))(?:\\s+WHERE\\s+((?:[#A-Za-z0-9_-]+\\s*(?:<=|>=|!=|<|>|=)\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)\\s+AND\\s+)*[#A-Za-z0-9_-]+\\s*(?:<=|>=|!=|<|>|=)\\s*(?:[0-9]+\\.[0-9]+|[A-Za-z0-9_-]+)))?\\s*;?"
 #define CUSTOM_CMD "\\s*FUNCTION\\s+([A-Za-z,#0-9\\s()_-]+)\\s*;?"
 
 #define REGEX(c) std::regex(c, std::regex_constants::icase)
@@ -50,22 +58,33 @@ class RegexHandler {
       {REGEX(DROP_TABLE_CMD), &RegexHandler::dropTableHandler},
       {REGEX(CREATE_INDEX_CMD), &RegexHandler::createIndexHandler},
       {REGEX(DROP_INDEX_CMD), &RegexHandler::dropIndexHandler},
+      {REGEX(CREATE_COMPOSITE_INDEX_CMD), &RegexHandler::createCompositeIndexHandler},
+      {REGEX(DROP_COMPOSITE_INDEX_CMD), &RegexHandler::dropCompositeIndexHandler},
       {REGEX(RENAME_TABLE_CMD), &RegexHandler::renameTableHandler},
       {REGEX(RENAME_COLUMN_CMD), &RegexHandler::renameColumnHandler},
       {REGEX(INSERT_SINGLE_CMD), &RegexHandler::insertSingleHandler},
       {REGEX(INSERT_MULTIPLE_CMD), &RegexHandler::insertFromFileHandler},
+      {REGEX(DELETE_FROM_CMD), &RegexHandler::deleteFromHandler},
+      {REGEX(UPDATE_SET_CMD), &RegexHandler::updateSetHandler},
       {REGEX(SELECT_FROM_CMD), &RegexHandler::selectFromHandler},
       {REGEX(SELECT_FROM_WHERE_CMD), &RegexHandler::selectFromWhereHandler},
       {REGEX(SELECT_ATTR_FROM_CMD), &RegexHandler::selectAttrFromHandler},
       {REGEX(SELECT_ATTR_FROM_WHERE_CMD), &RegexHandler::selectAttrFromWhereHandler},
+      {REGEX(SELECT_FROM_WHERE_AND_CMD), &RegexHandler::selectFromWhereAndHandler},
+      {REGEX(SELECT_ATTR_FROM_WHERE_AND_CMD), &RegexHandler::selectAttrFromWhereAndHandler},
       {REGEX(SELECT_FROM_JOIN_CMD), &RegexHandler::selectFromJoinHandler},
       {REGEX(SELECT_ATTR_FROM_JOIN_CMD), &RegexHandler::selectAttrFromJoinHandler},
+      {REGEX(SELECT_ORDER_BY_CMD), &RegexHandler::selectOrderByHandler},
       {REGEX(CUSTOM_CMD), &RegexHandler::customFunctionHandler},
   };
 
   // extract tokens delimited by whitespace and comma
   std::vector<std::string> extractTokens(std::string input);
 
+  // extract the attribute, operator and value of every condition of an AND-ed WHERE clause
+  void extractConditions(std::string input, std::vector<std::string> &attrs, std::vector<std::string> &ops,
+                         std::vector<std::string> &values);
+
   // handler functions
   std::smatch m;  // to store matches while parsing the regex
   int helpHandler();
@@ -78,16 +97,23 @@ class RegexHandler {
   int dropTableHandler();
   int createIndexHandler();
   int dropIndexHandler();
+  int createCompositeIndexHandler();
+  int dropCompositeIndexHandler();
   int renameTableHandler();
   int renameColumnHandler();
   int insertSingleHandler();
   int insertFromFileHandler();
+  int deleteFromHandler();
+  int updateSetHandler();
   int selectFromHandler();
   int selectFromWhereHandler();
   int selectAttrFromHandler();
   int selectAttrFromWhereHandler();
+  int selectFromWhereAndHandler();
+  int selectAttrFromWhereAndHandler();
   int selectFromJoinHandler();
   int selectAttrFromJoinHandler();
+  int selectOrderByHandler();
   int customFunctionHandler();
 
  public:
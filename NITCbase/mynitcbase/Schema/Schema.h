@@ -11,6 +11,8 @@ class Schema {
   static int deleteRel(char relName[ATTR_SIZE]);
   static int createIndex(char relName[ATTR_SIZE], char attrName[ATTR_SIZE]);
   static int dropIndex(char relName[ATTR_SIZE], char attrName[ATTR_SIZE]);
+  static int createIndex(char relName[ATTR_SIZE], int numAttrs, char attrNames[][ATTR_SIZE]);
+  static int dropIndex(char relName[ATTR_SIZE], int numAttrs, char attrNames[][ATTR_SIZE]);
   static int renameRel(char oldRelName[ATTR_SIZE], char newRelName[ATTR_SIZE]);
   static int renameAttr(char relName[ATTR_SIZE], char oldAttrName[ATTR_SIZE], char newAttrName[ATTR_SIZE]);
   static int openRel(char relName[ATTR_SIZE]);
@@ -3,10 +3,20 @@
 
 #define DISK_PATH "../Disk/disk"                            // Path to disk
 #define DISK_RUN_COPY_PATH "../Disk/disk_run_copy"          // Path to run copy of the disk
+#define DISK_DIR_PATH "../Disk/"                            // Path to the directory holding the disk and its run copy
+#define DISK_CLEAN_MARKER_PATH "../Disk/disk_clean"         // Path to marker recording that the run copy matches the disk
+#define DISK_WAL_PATH "../Disk/disk_wal"                    // Path to write-ahead log of block after-images
 #define Files_Path "../Files/"                              // Path to Files directory
 #define INPUT_FILES_PATH "../Files/Input_Files/"            // Path to Input_Files directory inside the Files directory
 #define OUTPUT_FILES_PATH "../Files/Output_Files/"          // Path to Output_Files directory inside the Files directory
 #define BATCH_FILES_PATH "../Files/Batch_Execution_Files/"  // Path to Batch_Execution_Files directory inside the Files directory
+#define DISK_MODE_ENV "NITCBASE_DISK_MODE"                  // Environment variable selecting the disk backend ("pread" or "mmap")
+#define WAL_SYNC_ENV "NITCBASE_WAL_SYNC"                    // Environment variable selecting the log fsync policy ("commit", "group" or "none")
+#define BUFFER_BLOCKS_ENV "NITCBASE_BUFFER_BLOCKS"          // Environment variable overriding the number of blocks in the Buffer
+#define BUFFER_STATS_ENV "NITCBASE_BUFFER_STATS"            // Environment variable enabling the Buffer hit/miss report at shutdown
+#define BUFFER_POLICY_ENV "NITCBASE_BUFFER_POLICY"          // Environment variable selecting the Buffer replacement policy ("lru", "clock" or "2q")
+#define READ_AHEAD_ENV "NITCBASE_READ_AHEAD"                // Environment variable overriding the number of blocks read ahead (0 disables)
+#define BUFFER_FLUSHER_ENV "NITCBASE_BUFFER_FLUSHER"        // Environment variable disabling the background writer when set to "0"
 
 #define BLOCK_SIZE 2048             // Size of Block in bytes
 #define ATTR_SIZE 16                // Size of an attribute in bytes
@@ -22,10 +32,20 @@
 #define LEAF_ENTRY_SIZE 32          // Size of an Leaf Index Entry in the Leaf Index Block (in bytes)
 
 #define DISK_BLOCKS 8192             // Number of block in disk
-#define BUFFER_CAPACITY 32           // Total number of blocks available in the Buffer (Capacity of the Buffer in blocks)
+#define BUFFER_CAPACITY 32           // Default number of blocks available in the Buffer (Capacity of the Buffer in blocks)
+#define MIN_BUFFER_CAPACITY 8        // Smallest Buffer capacity accepted from BUFFER_BLOCKS_ENV
+#define READ_AHEAD_BLOCKS 8          // Default number of blocks read ahead along a record or leaf index block chain
+#define FLUSH_INTERVAL_MS 100        // Time in milliseconds between rounds of the background writer
+#define FLUSH_BATCH_BLOCKS 64        // Maximum number of dirty blocks written per round of the background writer
+#define CHECKPOINT_INTERVAL_MS 5000  // Time in milliseconds between checkpoints taken by the background writer
 #define MAX_OPEN 12                  // Maximum number of relations allowed to be open and cached in Cache Layer.
 #define BLOCK_ALLOCATION_MAP_SIZE 4  // Number of blocks given for Block Allocation Map in the disk
 
+#define WAL_GROUP_COMMITS 8                 // Maximum number of commits sharing one fsync of the write-ahead log
+#define WAL_GROUP_WINDOW_MS 50              // Maximum time in milliseconds a commit stays unsynced before its group is fsync'ed
+#define WAL_BUFFER_SIZE (1024 * 1024)       // Size in bytes after which buffered log records are written out
+#define WAL_CHECKPOINT_SIZE (4 * 1024 * 1024)  // Size in bytes of the write-ahead log that triggers a checkpoint
+
 #define RELCAT_NO_ATTRS 6   // Number of attributes present in one entry / record of the Relation Catalog
 #define ATTRCAT_NO_ATTRS 6  // Number of attributes present in one entry / record of the Attribute Catalog
 
@@ -49,6 +69,7 @@
 enum AttributeType {
   NUMBER = 0,  // for an integer or a floating point number
   STRING = 1,
+  COMPOSITE = 2  // key of a composite index, the attribute values encoded so that they compare with memcmp
 };
 
 enum ConditionalOperators {
@@ -60,6 +81,11 @@ enum ConditionalOperators {
   NE   // !=
 };
 
+enum SortOrder {
+  ASC,  // ascending
+  DESC  // descending
+};
+
 enum BlockType {
   REC,           // record block
   IND_INTERNAL,  // internal index block
@@ -128,10 +154,17 @@ enum ReturnTypes {
 #define MIDDLE_INDEX_INTERNAL 50  // Index of the middle element in an Internal Node of a B+ tree
 #define MAX_KEYS_LEAF 63          // Maximum number of keys allowed in a Leaf Node of a B+ tree
 #define MIDDLE_INDEX_LEAF 31      // Index of the middle element in a Leaf Node of a B+ tree
+#define MIN_KEYS_INTERNAL 50      // Keys a non-root Internal Node keeps before a delete borrows from or merges with a sibling
+#define MIN_KEYS_LEAF 31          // Keys a non-root Leaf Node keeps before a delete borrows from or merges with a sibling
+#define INDEX_FILL_FACTOR 90      // Percentage of the maximum number of keys bulk load puts in each B+ tree node
+#define INDEX_REBUILD_RATIO 16    // A batch of at least 1/INDEX_REBUILD_RATIO of a tree's entries is merged into a rebuilt tree
+#define INSERT_BATCH_SIZE (256 * 1024)  // Size in bytes of records a bulk insert parses before writing them to blocks
+#define COMPOSITE_INDEX_MAX_ATTRS 4  // Maximum number of attributes a composite index can be built on
 
 // Name strings for Relation Catalog and Attribute Catalog (as it is stored in the Relation catalog)
 #define RELCAT_RELNAME "RELATIONCAT"
 #define ATTRCAT_RELNAME "ATTRIBUTECAT"
+#define INDEXCAT_RELNAME "INDEXCAT"  // created on the first composite index, like any other relation
 
 // Relation Catalog attribute name strings
 #define RELCAT_ATTR_RELNAME "RelName"
@@ -149,4 +182,10 @@ enum ReturnTypes {
 #define ATTRCAT_ATTR_ROOT_BLOCK "RootBlock"
 #define ATTRCAT_ATTR_OFFSET "Offset"
 
+// Index Catalog attribute name strings (AttributeName1 .. AttributeName4 hold the indexed attributes in order)
+#define INDEXCAT_ATTR_RELNAME "RelName"
+#define INDEXCAT_ATTR_NO_ATTRIBUTES "#Attributes"
+#define INDEXCAT_ATTR_ROOT_BLOCK "RootBlock"
+#define INDEXCAT_ATTR_ATTRIBUTE_NAME "AttributeName"
+
 #endif  // NITCBASE_CONSTANTS_H
\ No newline at end of file
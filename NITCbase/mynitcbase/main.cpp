@@ -6,7 +6,7 @@
 int main(int argc, char *argv[]) {
   /* Initialize the Run Copy of Disk */
   Disk disk_run;
-  // StaticBuffer buffer;
+  StaticBuffer buffer;
   // OpenRelTable cache;
 
   return FrontendInterface::handleFrontend(argc, argv);